@@ -2,11 +2,26 @@
 #include "shaders.h"
 
 #include "framework/Image.h"
+#include "framework/ImageCache.h"
 #include "framework/external/sokol_app.h" // DT_TODO: Remove
+#include <stdio.h>
 
 const uint32_t MAX_PFX_PARTICLES = 1200;
 const uint32_t MAX_TOTAL_PARTICLES = MAX_PFX_PARTICLES * 5;
 const uint32_t PFX_VERTEX_SIZE = (4 * 3 + 4 * 2 + 4 * 4);
+const uint32_t PFX_INSTANCE_SIZE = (4 * 4 + 4 * 4); // Position and size, then color (in separate streams)
+
+const uint32_t MAX_SECTOR_LIGHTS = 8; // Lights of the single pass shader (fs_params_lights), sectors with more use multipass
+
+// Put the room geometry of all sectors in one vertex and one index buffer, so batches only differ by their textures
+const bool PACK_SECTOR_GEOMETRY = true;
+
+const uint32_t DRAW_LAYER_OPAQUE = 0; // Single pass and ambient pass room draws
+const uint32_t DRAW_LAYER_LIGHTS = 1; // Additive light passes
+
+const uint64_t TEXTURE_BUDGET_BYTES = 64 * 1024 * 1024;
+const uint32_t TEXTURE_PREFETCH_DEPTH = 2; // Portals away from the camera sector to load textures for
+const float BUMP_NORMAL_SCALE = 8.0f;       // Height map to normal map scale (matches the shipped _N maps)
 
 struct PFXBuffer
 {
@@ -15,10 +30,40 @@ struct PFXBuffer
   vec4 color;
 };
 
+// Returns true if the sphere touches the box
+static inline bool sphere_touches_box(const vec3& pos, float radius, const vec3& boxMin, const vec3& boxMax) {
+  vec3 extents = (boxMax - boxMin) * 0.5f;
+  vec3 d = pos - findAABBClosestPoint(pos, boxMin + extents, extents);
+  return dot(d, d) < radius * radius;
+}
+
 BaseApp* BaseApp::CreateApp() {
   return new App();
 }
 
+bool App::OnEvent(const sapp_event* ev) {
+  // Toggle between instanced and CPU expanded particles
+  if (ev->type == SAPP_EVENTTYPE_KEY_DOWN && !ev->key_repeat && ev->key_code == SAPP_KEYCODE_I) {
+    pfxInstanced = !pfxInstanced;
+  }
+  // Toggle between single pass and multipass lighting
+  if (ev->type == SAPP_EVENTTYPE_KEY_DOWN && !ev->key_repeat && ev->key_code == SAPP_KEYCODE_L) {
+    singlePassLighting = !singlePassLighting;
+  }
+  // Toggle sorting the particles by depth
+  if (ev->type == SAPP_EVENTTYPE_KEY_DOWN && !ev->key_repeat && ev->key_code == SAPP_KEYCODE_P) {
+    pfxDepthSort = !pfxDepthSort;
+  }
+  // Toggle showing the draw list stats in the window title
+  if (ev->type == SAPP_EVENTTYPE_KEY_DOWN && !ev->key_repeat && ev->key_code == SAPP_KEYCODE_T) {
+    showDrawStats = !showDrawStats;
+    if (!showDrawStats) {
+      sapp_set_window_title("Portals");
+    }
+  }
+  return BaseApp::OnEvent(ev);
+}
+
 void App::ResetCamera() {
   camPos = vec3(470, 220, 210);
   wx = 0;
@@ -28,9 +73,13 @@ void App::ResetCamera() {
 
 bool App::Load() {
 
-  pfxBuffer.reserve(MAX_PFX_PARTICLES * 36 * 4);
-  workingBuffer1.reserve(8);
-  workingBuffer2.reserve(8);
+  jobSystem.init();
+
+  pfxBuffer.reserve(MAX_TOTAL_PARTICLES * PFX_VERTEX_SIZE * 4);
+  pfxDraws.reserve(64);
+  portalClipPoints.reserve(256);
+  portalOutcodes.reserve(64);
+  visibleQueue.reserve(64);
 
   {
     std::vector<uint16_t> indices;
@@ -53,6 +102,13 @@ bool App::Load() {
       .size = MAX_TOTAL_PARTICLES * PFX_VERTEX_SIZE * 4,
       .usage = SG_USAGE_STREAM
     });
+  {
+    // Billboard corners of the instanced particles, in the same order as ParticleSystem::fillVertexArray
+    const vec2 corners[] = { vec2(-1, 1), vec2(1, 1), vec2(1, -1), vec2(-1, -1) };
+    pfx_corners = sg_make_buffer(sg_buffer_desc{
+        .data = SG_RANGE(corners),
+      });
+  }
 
   {
     sg_sampler_desc smp_desc = {};
@@ -65,6 +121,7 @@ bool App::Load() {
   }
 
   shader = sg_make_shader(shd_shader_desc(sg_query_backend()));
+  lights_shader = sg_make_shader(shd_lights_shader_desc(sg_query_backend()));
 
   {
     sg_sampler_desc smp_desc = {};
@@ -78,19 +135,41 @@ bool App::Load() {
 
 
   pfx_shader = sg_make_shader(shd_pfx_shader_desc(sg_query_backend()));
+  pfx_inst_shader = sg_make_shader(shd_pfx_inst_shader_desc(sg_query_backend()));
+
+  // Room textures are streamed in when sectors become reachable (block compressed versions are used where they exist).
+  // The batches of all rooms cycle through the same three materials.
+  textureStreamer.init(&jobSystem, TEXTURE_BUDGET_BYTES);
+  const uint32_t flatNormal = 0xFFFF8080;
+  const uint32_t grey = 0xFF808080;
+  const uint32_t baseTextures[] = {
+    textureStreamer.addTexture("data/Wood.png",         "data/Wood.dds",         MIP_FILTER_SRGB, grey),
+    textureStreamer.addTexture("data/laying_rock7.png", "data/laying_rock7.dds", MIP_FILTER_SRGB, grey),
+    textureStreamer.addTexture("data/victoria.png",     "data/victoria.dds",     MIP_FILTER_SRGB, grey),
+  };
+  const uint32_t bumpTextures[] = {
+    textureStreamer.addTexture("data/WoodBump.png",         nullptr, MIP_FILTER_NORMAL, flatNormal, BUMP_NORMAL_SCALE),
+    textureStreamer.addTexture("data/laying_rock7Bump.png", nullptr, MIP_FILTER_NORMAL, flatNormal, BUMP_NORMAL_SCALE),
+    textureStreamer.addTexture("data/victoriaBump.png",     nullptr, MIP_FILTER_NORMAL, flatNormal, BUMP_NORMAL_SCALE),
+  };
 
-  base[0] = create_texture("data/Wood.png", loadBuffer);
-  base[1] = create_texture("data/laying_rock7.png", loadBuffer);
-  base[2] = create_texture("data/victoria.png", loadBuffer);
+  {
+    ImageData image;
+    load_image_cached("data/Particle.png", "cache", image);
+    pfx_particle = make_image(image);
+    free_image_data(image);
+  }
 
-  bump[0] = create_texture("data/Wood_N.png", loadBuffer);
-  bump[1] = create_texture("data/laying_rock7_N.png", loadBuffer);
-  bump[2] = create_texture("data/victoria_N.png", loadBuffer);
+  auto load_model = [](const char* filename, Sector& sector, vec3 offset) -> bool {
 
-  pfx_particle = create_texture("data/Particle.png", loadBuffer);
+    // Use the cooked model if it exists and is up to date (already offset with the model and batch bounds stored)
+    if (load_cooked_model(get_cooked_model_name(filename).c_str(), filename, offset, sector.room, sector.min, sector.max, sector.batchMin, sector.batchMax)) {
+      return true;
+    }
 
-  auto load_model = [](const char* filename, Sector& sector, vec3 offset) {
-    load_model_from_file(filename, sector.room);
+    if (!load_model_from_mapped_file(filename, sector.room)) {
+      return false;
+    }
 
     //mat4 mat(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
     //mat.translate(offset);
@@ -104,44 +183,101 @@ bool App::Load() {
 
     // Calculate min/max bounds
     get_bounding_box(sector.room, sector.min, sector.max);
-    make_model_renderable(sector.room);
-  };
-
-  load_model("data/room0.hmdl", sectors[0], vec3(0, 256, 0));
-  load_model("data/room1.hmdl", sectors[1], vec3(-384, 256, 3072));
-  load_model("data/room2.hmdl", sectors[2], vec3(1536, 256, 2688));
-  load_model("data/room3.hmdl", sectors[3], vec3(-1024, -768, 2688));
-  load_model("data/room4.hmdl", sectors[4], vec3(-2304, 256, 2688));
-
-  // Setup portals
-  sectors[0].portals.push_back(Portal(1, vec3(-384, 384, 1024), vec3(-128, 384, 1024), vec3(-384, 0, 1024)));
-  sectors[1].portals.push_back(Portal(0, vec3(-384, 384, 1024), vec3(-128, 384, 1024), vec3(-384, 0, 1024)));
 
-  sectors[1].portals.push_back(Portal(2, vec3(512, 384, 2816), vec3(512, 384, 3072), vec3(512, 0, 2816)));
-  sectors[2].portals.push_back(Portal(1, vec3(512, 384, 2816), vec3(512, 384, 3072), vec3(512, 0, 2816)));
-
-  sectors[2].portals.push_back(Portal(3, vec3(512, -256, 2304), vec3(512, -256, 2560), vec3(512, -640, 2304)));
-  sectors[3].portals.push_back(Portal(2, vec3(512, -256, 2304), vec3(512, -256, 2560), vec3(512, -640, 2304)));
+    // Batch bounds for light culling, before the vertex data is released (falls back to the sector bounds)
+    size_t batchCount = sector.room.batches.size();
+    sector.batchMin.assign(batchCount, vec3(FLT_MAX));
+    sector.batchMax.assign(batchCount, vec3(-FLT_MAX));
+    for (size_t i = 0; i < batchCount; i++) {
+      if (!get_bounding_box(sector.room.batches[i], sector.batchMin[i], sector.batchMax[i])) {
+        sector.batchMin[i] = sector.min;
+        sector.batchMax[i] = sector.max;
+      }
+    }
+    return true;
+  };
 
-  sectors[1].portals.push_back(Portal(4, vec3(-1280, 384, 1664), vec3(-1280, 384, 1920), vec3(-1280, 128, 1664)));
-  sectors[4].portals.push_back(Portal(1, vec3(-1280, 384, 1664), vec3(-1280, 384, 1920), vec3(-1280, 128, 1664)));
+  LevelData level;
+  MappedFile levelFile;
+  if (!load_level_from_file("data/demo.lvl", levelFile, level) ||
+      level.header->sectorCount == 0) {
+    return false;
+  }
 
-  sectors[1].portals.push_back(Portal(4, vec3(-1280, 192, 3840), vec3(-1280, 192, 4096), vec3(-1280, -256, 3840)));
-  sectors[4].portals.push_back(Portal(1, vec3(-1280, 192, 3840), vec3(-1280, 192, 4096), vec3(-1280, -256, 3840)));
+  sectors.resize(level.header->sectorCount);
+  for (uint32_t i = 0; i < level.header->sectorCount; i++) {
+    const LevelSector& levelSector = level.sectors[i];
+    Sector& sector = sectors[i];
+    if (!load_model(level.getString(levelSector.modelName), sector, glm::make_vec3(levelSector.offset))) {
+      return false;
+    }
 
-  // Setup lights
-  sectors[0].lights.push_back(Light(vec3(0, 128, 0), 800, 100, 100, 100));
+    // Setup portals
+    for (uint32_t p = 0; p < levelSector.portalCount; p++) {
+      const LevelPortal& portal = level.portals[levelSector.portalStart + p];
+      sector.portals.push_back(Portal(portal.sector,
+                                      glm::make_vec3(portal.corners[0]),
+                                      glm::make_vec3(portal.corners[1]),
+                                      glm::make_vec3(portal.corners[2])));
+    }
+    sector.updatePortalCorners();
+    size_t batchCount = sector.room.batches.size();
+    sector.baseTextures.resize(batchCount);
+    sector.bumpTextures.resize(batchCount);
+    for (size_t b = 0; b < batchCount; b++) {
+      sector.baseTextures[b] = baseTextures[b % std::size(baseTextures)];
+      sector.bumpTextures[b] = bumpTextures[b % std::size(bumpTextures)];
+    }
+    sectorGrid.addBox(sector.min, sector.max);
 
-  sectors[1].lights.push_back(Light(vec3(-256, 224, 1800), 650, 100, 80, 100));
-  sectors[1].lights.push_back(Light(vec3(-512, 128, 3100), 900, 100, 100, 300));
+    // Setup lights
+    for (uint32_t l = 0; l < levelSector.lightCount; l++) {
+      uint32_t lightIndex = levelSector.lightStart + l;
+      sector.lights.push_back(Light(level.lights[lightIndex], lightIndex));
+    }
+  }
+  sectorGrid.build();
 
-  sectors[2].lights.push_back(Light(vec3(1300, 128, 2700), 800, 100, 100, 200));
+  // Upload the room geometry, then release the CPU side data
+  std::vector<Model*> rooms;
+  for (Sector& sector : sectors) {
+    rooms.push_back(&sector.room);
+  }
+  uint32_t roomIndexSize = sizeof(uint16_t);
+  bool packed = PACK_SECTOR_GEOMETRY && make_models_renderable_packed(rooms.data(), (uint32_t)rooms.size(), roomIndexSize);
+  for (Model* room : rooms) {
+    if (!packed && !make_model_renderable(*room)) {
+      return false;
+    }
+    free_model_cpu_data(*room);
+  }
 
-  sectors[3].lights.push_back(Light(vec3(-100, -700, 2432), 600, 50, 50, 50));
-  sectors[3].lights.push_back(Light(vec3(-1450, -700, 2900), 1200, 250, 80, 250));
+  // Find the lights that can reach into a neighbouring sector through a portal.
+  // Lights move by up to their offset scale, so the reach is padded by it.
+  for (Sector& sector : sectors) {
+    for (const Portal& portal : sector.portals) {
+      const Sector& other = sectors[portal.sector];
+      vec3 portalMin = glm::min(glm::min(portal.v[0], portal.v[1]), glm::min(portal.v[2], portal.v[3]));
+      vec3 portalMax = glm::max(glm::max(portal.v[0], portal.v[1]), glm::max(portal.v[2], portal.v[3]));
+      for (uint32_t l = 0; l < (uint32_t)other.lights.size(); l++) {
+        const Light& light = other.lights[l];
+        float reach = light.radius + length(vec3(light.xs, light.ys, light.zs));
+        if (!sphere_touches_box(light.position, reach, portalMin, portalMax) ||
+            !sector.isSphereInSector(light.position, reach)) {
+          continue;
+        }
 
-  sectors[4].lights.push_back(Light(vec3(-2200, 256, 2300), 800, 100, 100, 100));
-  sectors[4].lights.push_back(Light(vec3(-2000, 0, 4000), 800, 100, 100, 100));
+        // There can be several portals into the same sector
+        bool found = false;
+        for (const SectorLightRef& ref : sector.portalLights) {
+          found |= (ref.sector == portal.sector && ref.light == l);
+        }
+        if (!found) {
+          sector.portalLights.push_back(SectorLightRef{ portal.sector, l });
+        }
+      }
+    }
+  }
 
   {
     sg_pipeline_desc roomPipDesc = {};
@@ -151,7 +287,7 @@ bool App::Load() {
     roomPipDesc.layout.attrs[3] = { .offset = 32, .format = SG_VERTEXFORMAT_FLOAT3 }; // mat1
     roomPipDesc.layout.attrs[4] = { .offset = 44, .format = SG_VERTEXFORMAT_FLOAT3 }; // mat2
     roomPipDesc.shader = shader;
-    roomPipDesc.index_type = SG_INDEXTYPE_UINT16;
+    roomPipDesc.index_type = (roomIndexSize == sizeof(uint32_t)) ? SG_INDEXTYPE_UINT32 : SG_INDEXTYPE_UINT16;
     roomPipDesc.depth = {
         .compare = SG_COMPAREFUNC_LESS_EQUAL,
         .write_enabled = true,
@@ -160,6 +296,10 @@ bool App::Load() {
     //roomPipDesc.face_winding = SG_FACEWINDING_CCW;
     room_pipline = sg_make_pipeline(roomPipDesc);
 
+    roomPipDesc.shader = lights_shader;
+    room_lights_pipline = sg_make_pipeline(roomPipDesc);
+    roomPipDesc.shader = shader;
+
     roomPipDesc.colors[0].blend = {
         .enabled = true,
         .src_factor_rgb = SG_BLENDFACTOR_ONE,
@@ -191,202 +331,426 @@ bool App::Load() {
     pipDesc.cull_mode = SG_CULLMODE_BACK;
     //pipDesc.face_winding = SG_FACEWINDING_CCW;
     pfx_pipline = sg_make_pipeline(pipDesc);
+
+    // Instanced billboards, the corners are expanded in the vertex shader
+    pipDesc.layout = {};
+    pipDesc.layout.buffers[1].step_func = SG_VERTEXSTEP_PER_INSTANCE;
+    pipDesc.layout.buffers[2].step_func = SG_VERTEXSTEP_PER_INSTANCE;
+    pipDesc.layout.attrs[ATTR_vs_pfx_inst_corner] = { .buffer_index = 0, .format = SG_VERTEXFORMAT_FLOAT2 };
+    pipDesc.layout.attrs[ATTR_vs_pfx_inst_inst_pos_size] = { .buffer_index = 1, .format = SG_VERTEXFORMAT_FLOAT4 };
+    pipDesc.layout.attrs[ATTR_vs_pfx_inst_inst_color] = { .buffer_index = 2, .format = SG_VERTEXFORMAT_FLOAT4 };
+    pipDesc.shader = pfx_inst_shader;
+    pfx_inst_pipline = sg_make_pipeline(pipDesc);
   }
 
   return true;
 }
 
-void App::DrawFrame() {
+const uint32_t MAX_PORTAL_DEPTH = 16;
 
-  vs_params_t room_params;
-  vs_params_pfx_t pfx_params;
+uint32_t App::FindSector(const vec3& pos) {
 
-  const int w = sapp_width(); // DT_TODO: Move to internal state
-  const int h = sapp_height();
+  // Check the last sector and the sectors through its portals first (the camera rarely moves far in a frame)
+  const Sector& lastSector = sectors[currSector];
+  if (lastSector.isInBoundingBox(pos)) {
+    return currSector;
+  }
+  for (const Portal& portal : lastSector.portals) {
+    if (sectors[portal.sector].isInBoundingBox(pos)) {
+      return portal.sector;
+    }
+  }
 
-  //mat4 proj = glm::tweakedInfinitePerspective(1.5, 1.0, 0.2);
-  //mat4 proj = glm::perspectiveFovLH_NO(1.5f, float(w), float(h), 0.1f, 6000.0f); // This is the same as perspectiveMatrixX, but the FOV is in height
+  // Look up the sectors that overlap the grid cell of the position
+  const uint32_t* cellSectors = nullptr;
+  uint32_t cellCount = sectorGrid.getCellBoxes(pos, cellSectors);
+  for (uint32_t i = 0; i < cellCount; i++) {
+    if (sectors[cellSectors[i]].isInBoundingBox(pos)) {
+      return cellSectors[i];
+    }
+  }
 
-  mat4 proj = perspectiveMatrixX(1.5f, w, h, 0.1f, 6000);
-  mat4 mv = rotateXY(-wx, -wy) * translate(-camPos);
+  // If not inside any sector (eg. in a doorway between boxes), use the nearest one.
+  // A sector outside the cell can be nearer than the sectors in it, so the grid searches outwards from the cell.
+  uint32_t retSector = currSector;
+  float distanceSqr;
+  sectorGrid.findNearestBox(pos, retSector, distanceSqr);
+
+  return retSector;
+}
 
-  unsigned int currSector = 0;
-  float minDist = 1e10f;
+void App::RequestSectorTextures(uint32_t sectorIndex, uint32_t priority) {
+  const Sector& sector = sectors[sectorIndex];
+  for (uint32_t id : sector.baseTextures) {
+    textureStreamer.request(id, priority);
+  }
+  for (uint32_t id : sector.bumpTextures) {
+    textureStreamer.request(id, priority);
+  }
+}
 
-  for (uint32_t i = 0; i < 5; i++) {
-    sectors[i].hasBeenDrawn = false;
+void App::PrefetchSectorTextures(uint32_t startSector) {
 
-    // Works for this demo since all sectors have non-intersecting bounding boxes
-    // Real large-scale applications would have to implement more sophisticated
-    // ways to detect which sector the camera resides in.
-    //if (sectors[i]->isInBoundingBox(position)) currSector = i;
-    float d = sectors[i].getDistanceSqr(camPos);
-    if (d < minDist) {
-      currSector = i;
-      minDist = d;
+  // Breadth first through the portal graph, the priority is the number of portals away
+  for (Sector& sector : sectors) {
+    sector.streamDistance = UINT32_MAX;
+  }
+  streamQueue.clear();
+  streamQueue.push_back(startSector);
+  sectors[startSector].streamDistance = 0;
+
+  for (size_t i = 0; i < streamQueue.size(); i++) {
+    const Sector& sector = sectors[streamQueue[i]];
+    RequestSectorTextures(streamQueue[i], sector.streamDistance);
+    if (sector.streamDistance >= TEXTURE_PREFETCH_DEPTH) {
+      continue;
+    }
+
+    for (const Portal& portal : sector.portals) {
+      Sector& next = sectors[portal.sector];
+      if (next.streamDistance == UINT32_MAX) {
+        next.streamDistance = sector.streamDistance + 1;
+        streamQueue.push_back(portal.sector);
+      }
     }
   }
+}
 
-  room_params.mvp = proj * mv;
-  room_params.camPos = vec4(camPos, 1.0);
-  pfx_params.mvp = room_params.mvp;
+void App::GatherSectorLights(uint32_t sectorIndex) {
 
-  vec3 dx(mv[0][0], mv[1][0], mv[2][0]);
-  vec3 dy(mv[0][1], mv[1][1], mv[2][1]);
+  const Sector& sector = sectors[sectorIndex];
+  sectorLights.clear();
 
-  sg_pass_action pass_action = {};
-  pass_action.colors[0] = { .load_action = SG_LOADACTION_CLEAR, .clear_value = { 0.1f, 0.1f, 0.1f, 1.0f } };
+  // Keep the lights that reach the sector and can be seen. Lights of neighbouring sectors use the offset of their own sector.
+  auto addLight = [this, &sector](const Light& light, uint32_t j) {
+    VisibleLight visible;
+    visible.position = light.position + light.CalcLightOffset(app_time - 0.1f, float(j));
+    visible.radius = light.radius;
+    if (sector.isSphereInSector(visible.position, visible.radius) &&
+        testAABBFrustumPlanes(frustumPlanes, visible.position, vec3(visible.radius))) {
+      sectorLights.push_back(visible);
+    }
+  };
 
-  sg_begin_default_pass(&pass_action, (int)w, (int)h);
+  for (uint32_t j = 0; j < (uint32_t)sector.lights.size(); j++) {
+    addLight(sector.lights[j], j);
+  }
+  for (const SectorLightRef& ref : sector.portalLights) {
+    addLight(sectors[ref.sector].lights[ref.light], ref.light);
+  }
+}
 
-  auto draw_sector = [&](uint32_t draw_index) {
+void App::DrawSector(uint32_t sectorIndex, const ScreenRect& rect) {
+
+  Sector& sector = sectors[sectorIndex];
+  GatherSectorLights(sectorIndex);
+
+  // Draws are recorded, then sorted and submitted once all the visible sectors are recorded
+  auto recordBatch = [this, &sector](uint32_t layer, sg_pipeline pipeline, uint32_t i, uint32_t vsUniforms, uint32_t fsUniforms, const ScreenRect& scissor) {
+    const Batch& batch = sector.room.batches[i];
+    DrawCommand command;
+    command.pipeline = pipeline;
+    command.bindings.index_buffer = batch.render_index;
+    command.bindings.vertex_buffers[0] = batch.render_vertex;
+    command.bindings.fs.images[0] = textureStreamer.getImage(sector.baseTextures[i]);
+    command.bindings.fs.images[1] = textureStreamer.getImage(sector.bumpTextures[i]);
+    command.bindings.fs.samplers[0] = smp;
+    command.key = make_draw_key(layer, pipeline, command.bindings.fs.images[0], command.bindings.fs.images[1], batch.render_vertex);
+    command.vsUniforms = vsUniforms;
+    command.fsUniforms = fsUniforms;
+    command.scissorX = scissor.x;
+    command.scissorY = scissor.y;
+    command.scissorWidth = scissor.width;
+    command.scissorHeight = scissor.height;
+    command.baseElement = batch.baseElement;
+    command.numElements = batch.nIndices;
+    drawList.draw(command);
+  };
 
-    Sector& sector = sectors[draw_index];
-    sector.hasBeenDrawn = true;
-    for (int j = 0; j < sector.lights.size(); j++)
+  // Skip the batches out of view, and count the lights that reach each batch
+  uint32_t batchCount = (uint32_t)sector.room.batches.size();
+  batchVisible.resize(batchCount);
+  uint32_t maxBatchLights = 0;
+  for (uint32_t i = 0; i < batchCount; i++)
+  {
+    vec3 extents = (sector.batchMax[i] - sector.batchMin[i]) * 0.5f;
+    batchVisible[i] = testAABBFrustumPlanes(frustumPlanes, sector.batchMin[i] + extents, extents);
+
+    uint32_t batchLights = 0;
+    for (const VisibleLight& light : sectorLights)
+    {
+      batchLights += sphere_touches_box(light.position, light.radius, sector.batchMin[i], sector.batchMax[i]) ? 1 : 0;
+    }
+    if (batchVisible[i] && batchLights > maxBatchLights)
     {
-      Light& light = sector.lights[j];
-      vec3 p = light.CalcLightOffset(app_time - 0.1f, float(j));
+      maxBatchLights = batchLights;
+    }
+  }
 
-      fs_params_t room_params_fs{};
-      room_params_fs.invRadius = 1.0f / light.radius;
-      room_params.lightPos = vec4(light.position + p, 1.0);
+  // Draw each batch once with all the lights that reach it
+  if (singlePassLighting && maxBatchLights <= MAX_SECTOR_LIGHTS)
+  {
+    vs_params_lights_t lights_params;
+    lights_params.mvp = viewProj;
+    lights_params.camPos = vec4(camPos, 1.0);
 
-      if (j == 0) {
-        room_params_fs.ambient = 0.07f;
-        sg_apply_pipeline(room_pipline);
-      }
-      else {
-        sg_apply_pipeline(room_pipline_blend);
+    uint32_t vsUniforms = drawList.addUniforms(lights_params);
+    for (uint32_t i = 0; i < batchCount; i++)
+    {
+      if (!batchVisible[i])
+      {
+        continue;
       }
 
-      sg_apply_uniforms(SG_SHADERSTAGE_VS, 0, SG_RANGE_REF(room_params));
-      sg_apply_uniforms(SG_SHADERSTAGE_FS, 0, SG_RANGE_REF(room_params_fs));
-      for (int i = 0; i < 3; i++)
+      fs_params_lights_t lights_params_fs{};
+      lights_params_fs.ambient = 0.07f;
+      uint32_t lightCount = 0;
+      for (const VisibleLight& light : sectorLights)
       {
-        const Batch& batch = sector.room.batches[i];
-        sg_bindings binding = {};
-        binding.index_buffer = batch.render_index;
-        binding.vertex_buffers[0] = batch.render_vertex;
-        binding.fs.images[0] = base[i];
-        binding.fs.images[1] = bump[i];
-        binding.fs.samplers[0] = smp;
-        sg_apply_bindings(&binding);
-        sg_draw(0, batch.nIndices, 1);
+        if (sphere_touches_box(light.position, light.radius, sector.batchMin[i], sector.batchMax[i]))
+        {
+          lights_params_fs.lights[lightCount++] = vec4(light.position, 1.0f / light.radius);
+        }
       }
+      lights_params_fs.lightCount = float(lightCount);
+      recordBatch(DRAW_LAYER_OPAQUE, room_lights_pipline, i, vsUniforms, drawList.addUniforms(lights_params_fs), rect);
     }
-  };
-  draw_sector(currSector);
+    return;
+  }
+
+  // Multipass, draw each batch once per light with additive blending.
+  // The first pass also adds the ambient term over the whole portal area, the other passes are scissored to the screen area of the light.
+  vs_params_t room_params;
+  room_params.mvp = viewProj;
+  room_params.camPos = vec4(camPos, 1.0);
 
-  // Recurse through portals- Determine if the portal bounds are visible
-  // Doing simple test if portal area is in camera frustum (original demo used queries with GL_SAMPLES_PASSED)
-  for (Portal& portal : sectors[currSector].portals)
+  uint32_t passCount = max(1u, (uint32_t)sectorLights.size());
+  for (uint32_t j = 0; j < passCount; j++)
   {
-    // Cannot do this test if scissoring as there can be multiple portals into the sector - Perhaps disable scissoring if drawing multiple times is very slow?
-    //if (!sectors[portal.sector].hasBeenDrawn) 
+    fs_params_t room_params_fs{};
+    if (j < sectorLights.size()) {
+      room_params_fs.invRadius = 1.0f / sectorLights[j].radius;
+      room_params.lightPos = vec4(sectorLights[j].position, 1.0);
+    }
+    else {
+      // Ambient only, the light does not reach past the near plane
+      room_params_fs.invRadius = 100.0f;
+      room_params.lightPos = vec4(camPos, 1.0);
+    }
+
+    ScreenRect scissor = rect;
+    if (j == 0) {
+      room_params_fs.ambient = 0.07f;
+    }
+    else {
+      const VisibleLight& light = sectorLights[j];
+      if (!getBoxScreenArea(viewProj, light.position, vec3(light.radius), screenWidth, screenHeight, scissor.x, scissor.y, scissor.width, scissor.height) ||
+          !scissor.intersect(rect)) {
+        continue;
+      }
+    }
+
+    // The ambient pass is drawn before all the additive passes (which need its depth)
+    uint32_t layer = (j == 0) ? DRAW_LAYER_OPAQUE : DRAW_LAYER_LIGHTS;
+    sg_pipeline pipeline = (j == 0) ? room_pipline : room_pipline_blend;
+    uint32_t vsUniforms = drawList.addUniforms(room_params);
+    uint32_t fsUniforms = drawList.addUniforms(room_params_fs);
+    for (uint32_t i = 0; i < batchCount; i++)
+    {
+      // The first pass draws every visible batch for the ambient term
+      if (!batchVisible[i] ||
+          (j > 0 && !sphere_touches_box(sectorLights[j].position, sectorLights[j].radius, sector.batchMin[i], sector.batchMax[i]))) {
+        continue;
+      }
+      recordBatch(layer, pipeline, i, vsUniforms, fsUniforms, scissor);
+    }
+  }
+}
+
+void App::FindVisibleSectors(uint32_t startSector, const ScreenRect& rect) {
+
+  // Walk the portal graph breadth first. Each sector gets the bounds of the screen areas it is seen through, and is processed
+  // again only when that area grows (so each sector is drawn once, and the walk does not depend on the number of portal paths).
+  Sector& start = sectors[startSector];
+  start.hasBeenDrawn = true;
+  start.visibleRect = rect;
+  start.portalDepth = 0;
+  start.isQueued = true;
+  visibleQueue.clear();
+  visibleQueue.push_back(startSector);
+
+  for (size_t q = 0; q < visibleQueue.size(); q++) {
+    Sector& sector = sectors[visibleQueue[q]];
+    sector.isQueued = false;
+    if (sector.portalDepth >= MAX_PORTAL_DEPTH) {
+      continue;
+    }
+    const ScreenRect sectorRect = sector.visibleRect;
+
+    // Determine if the portal bounds are visible
+    // Doing simple test if portal area is in camera frustum (original demo used queries with GL_SAMPLES_PASSED)
+    uint32_t portalCount = (uint32_t)sector.portals.size();
+
+    // Transform all the portal corners of the sector into clip space at once.
+    // Cull in clip space - the outcode is non-zero if all corners are outside one of the six clip planes.
+    // Simple fast test- may still be offscreen if passing this test. (can clip corner)
+    //  NOTE: Attempting to use Normalized Device Coordinates(NDC) causes issues when the portal intersects the near clip plane 
+    //        (w is positive and negative on different points)
+    portalOutcodes.resize(portalCount);
+    portalClipPoints.resize(portalCount * 4);
+    transformQuadsToClipSpace(viewProj, sector.portalX.data(), sector.portalY.data(), sector.portalZ.data(), portalCount,
+                              portalClipPoints.data(), portalOutcodes.data());
+
+    for (uint32_t p = 0; p < portalCount; p++)
     {
-      vec4 projPt[4];
+      const Portal& portal = sector.portals[p];
+      if (portalOutcodes[p] != 0) {
+        continue;
+      }
+
+      ClipPoly clipPoly;
+      clipPoly.count = 4;
       for (uint32_t i = 0; i < 4; i++)
       {
-        projPt[i] = room_params.mvp * vec4(portal.v[i], 1.0f);
+        clipPoly.points[i] = portalClipPoints[p * 4 + i];
       }
 
-      // Cull in clip space - cull against each six clip planes. Simple fast test- may still be offscreen if passing this test. (can clip corner)
-      //  NOTE: Attempting to use Normalized Device Coordinates(NDC) causes issues when the portal intersects the near clip plane 
-      //        (w is positive and negative on different points)
-      bool cull = false;
-      for (uint32_t i = 0; i < 3; i++)
+      ScreenRect portalRect;
+      if (!getPolyScreenArea(clipPoly, screenWidth, screenHeight, false, portalRect.x, portalRect.y, portalRect.width, portalRect.height))
       {
-        if (projPt[0][i] < -projPt[0].w &&
-            projPt[1][i] < -projPt[1].w &&
-            projPt[2][i] < -projPt[2].w &&
-            projPt[3][i] < -projPt[3].w)
-        {
-          cull = true;
-          break;
-        }
-        if (projPt[0][i] > projPt[0].w &&
-            projPt[1][i] > projPt[1].w &&
-            projPt[2][i] > projPt[2].w &&
-            projPt[3][i] > projPt[3].w)
-        {
-          cull = true;
-          break;
-        }
+        continue;
       }
 
-      if (!cull)
+      // Narrow the visible area to what can be seen through the portals leading here
+      if (!portalRect.intersect(sectorRect))
       {
-        workingBuffer1.resize(0);
-        workingBuffer2.resize(0);
-
-        workingBuffer1.push_back(projPt[0]);
-        workingBuffer1.push_back(projPt[1]);
-        workingBuffer1.push_back(projPt[2]);
-        workingBuffer1.push_back(projPt[3]);
-
-        uint32_t startX;
-        uint32_t startY;
-        uint32_t width;
-        uint32_t height;
-
-        if (!getPolyScreenArea(workingBuffer1, workingBuffer2, w, h, false, startX, startY, width, height))
-        {
-          cull = true;
-        }
-        else
-        {
-          // Scissor drawing area (minor optimization)
-          sg_apply_scissor_rect(startX, startY, width, height, true);
+        continue;
+      }
 
 #if 0
 //#ifdef SOKOL_GL
-          // Debug draw scissor bounds
-          sgl_matrix_mode_modelview();
-          sgl_load_identity();
-          sgl_matrix_mode_projection();
-          sgl_load_identity();
-          sgl_ortho(0.0f, (float)w, 0.0f, (float)h, -1.0f, 1.0f);
-
-          sgl_scissor_rect(startX, startY, width, height, true);
-
-          sgl_begin_quads();
-          sgl_v3f_c3f(0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-          sgl_v3f_c3f((float)w, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-          sgl_v3f_c3f((float)w, (float)h, 0.0f, 0.0f, 1.0f, 0.0f);
-          sgl_v3f_c3f(0.0f, (float)h, 0.0f, 0.0f, 1.0f, 0.0f);
-          sgl_end();
-
-          sgl_scissor_rect(0, 0, w, h, true);
-
-          // Debug draw portal bounds
-          sgl_matrix_mode_modelview();
-          sgl_load_matrix(value_ptr(mv));
-          sgl_matrix_mode_projection();
-          sgl_load_matrix(value_ptr(proj));
-
-          sgl_begin_quads();
-          for (uint32_t i = 0; i < 4; i++)
-          {
-            sgl_v3f_c3f(portal.v[i].x, portal.v[i].y, portal.v[i].z, 1.0f, 0.0f, 0.0f);
-          }
-          sgl_end();
+      // Debug draw scissor bounds
+      sgl_matrix_mode_modelview();
+      sgl_load_identity();
+      sgl_matrix_mode_projection();
+      sgl_load_identity();
+      sgl_ortho(0.0f, (float)screenWidth, 0.0f, (float)screenHeight, -1.0f, 1.0f);
+
+      sgl_scissor_rect(portalRect.x, portalRect.y, portalRect.width, portalRect.height, true);
+
+      sgl_begin_quads();
+      sgl_v3f_c3f(0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
+      sgl_v3f_c3f((float)screenWidth, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
+      sgl_v3f_c3f((float)screenWidth, (float)screenHeight, 0.0f, 0.0f, 1.0f, 0.0f);
+      sgl_v3f_c3f(0.0f, (float)screenHeight, 0.0f, 0.0f, 1.0f, 0.0f);
+      sgl_end();
+
+      sgl_scissor_rect(0, 0, screenWidth, screenHeight, true);
+
+      // Debug draw portal bounds
+      sgl_matrix_mode_modelview();
+      sgl_load_identity();
+      sgl_matrix_mode_projection();
+      sgl_load_matrix(value_ptr(viewProj));
+
+      sgl_begin_quads();
+      for (uint32_t i = 0; i < 4; i++)
+      {
+        sgl_v3f_c3f(portal.v[i].x, portal.v[i].y, portal.v[i].z, 1.0f, 0.0f, 0.0f);
+      }
+      sgl_end();
 #endif //SOKOL_GL
 
-        }
+      // Portals leading back to sectors that are already seen through this area add nothing (this also stops cycles)
+      Sector& next = sectors[portal.sector];
+      if (!next.hasBeenDrawn) {
+        next.hasBeenDrawn = true;
+        next.visibleRect = portalRect;
+        next.portalDepth = sector.portalDepth + 1;
+      }
+      else if (!next.visibleRect.contains(portalRect)) {
+        next.visibleRect.merge(portalRect);
+      }
+      else {
+        continue;
       }
 
-      if (!cull)
-      {
-        draw_sector(portal.sector);
+      if (!next.isQueued) {
+        next.isQueued = true;
+        visibleQueue.push_back(portal.sector);
       }
     }
   }
+}
+
+void App::DrawFrame() {
+
+  vs_params_pfx_t pfx_params;
+  vs_params_pfx_inst_t pfx_inst_params;
+
+  const int w = sapp_width(); // DT_TODO: Move to internal state
+  const int h = sapp_height();
+  screenWidth = (uint32_t)w;
+  screenHeight = (uint32_t)h;
+
+  //mat4 proj = glm::tweakedInfinitePerspective(1.5, 1.0, 0.2);
+  //mat4 proj = glm::perspectiveFovLH_NO(1.5f, float(w), float(h), 0.1f, 6000.0f); // This is the same as perspectiveMatrixX, but the FOV is in height
+
+  mat4 proj = perspectiveMatrixX(1.5f, w, h, 0.1f, 6000);
+  mat4 mv = rotateXY(-wx, -wy) * translate(-camPos);
+
+  for (Sector& sector : sectors) {
+    sector.hasBeenDrawn = false;
+  }
+  currSector = FindSector(camPos);
+
+  viewProj = proj * mv;
+  getProjectionPlanes(viewProj, frustumPlanes);
+  planeNormalize(frustumPlanes, 6);
+  pfx_params.mvp = viewProj;
+
+  vec3 dx(mv[0][0], mv[1][0], mv[2][0]);
+  vec3 dy(mv[0][1], mv[1][1], mv[2][1]);
+  pfx_inst_params.mvp = viewProj;
+  pfx_inst_params.dx = vec4(dx, 0.0f);
+  pfx_inst_params.dy = vec4(dy, 0.0f);
+
+  sg_pass_action pass_action = {};
+  pass_action.colors[0] = { .load_action = SG_LOADACTION_CLEAR, .clear_value = { 0.1f, 0.1f, 0.1f, 1.0f } };
+
+  sg_begin_default_pass(&pass_action, (int)w, (int)h);
+
+  // Find the sectors visible through the portals from the camera sector, then draw each once.
+  // The sector draws are scissored to the visible portal area (minor optimization)
+  ScreenRect screenRect = { 0, 0, screenWidth, screenHeight };
+  FindVisibleSectors(currSector, screenRect);
+  drawList.reset();
+  for (uint32_t i = 0; i < (uint32_t)sectors.size(); i++)
+  {
+    Sector& sector = sectors[i];
+    if (sector.hasBeenDrawn)
+    {
+      RequestSectorTextures(i, sector.portalDepth);
+      DrawSector(i, sector.visibleRect);
+    }
+  }
+  drawList.submit();
+  if (showDrawStats)
+  {
+    const DrawListStats& stats = drawList.getStats();
+    char title[256];
+    snprintf(title, sizeof(title), "Portals - draws %u, pipelines %u (%u skipped), bindings %u (%u skipped), uniforms %u (%u skipped), scissors %u (%u skipped)",
+      stats.draws, stats.pipelines, stats.pipelinesSkipped, stats.bindings, stats.bindingsSkipped, stats.uniforms, stats.uniformsSkipped,
+      stats.scissors, stats.scissorsSkipped);
+    sapp_set_window_title(title);
+  }
 
   // Reset scissor from portal geometry drawing
   sg_apply_scissor_rect(0, 0, w, h, true);
 
-  uint32_t particleCount = 0;
+  // Gather the particle systems of the drawn sectors that are visible through the portals.
+  // Culled systems are paused like the systems of sectors that are not drawn.
+  pfxDraws.clear();
   for (Sector& sector : sectors)
   {
     if (sector.hasBeenDrawn)
@@ -396,27 +760,20 @@ void App::DrawFrame() {
         Light& light = sector.lights[j];
         vec3 p = light.CalcLightOffset(app_time, float(j));
 
-        ParticleSystem& particles = light.particles;
-        particles.setPosition(light.position + p);
-        particles.update(app_time);
+        light.particles.setPosition(light.position + p);
 
-        uint32_t pfxCount = particles.getParticleCount();
-        if (pfxCount > MAX_PFX_PARTICLES)
-        {
-          pfxCount = MAX_PFX_PARTICLES;
-        }
-        if ((particleCount + pfxCount) > MAX_TOTAL_PARTICLES)
-        {
-          pfxCount = MAX_TOTAL_PARTICLES - particleCount;
-        }
+        vec3 center;
+        float radius;
+        light.particles.getBoundingSphere(center, radius);
 
-        // Have an append buffer + render once
-        if (pfxCount > 0)
+        ScreenRect pfxRect;
+        if (!getBoxScreenArea(viewProj, center, vec3(radius), screenWidth, screenHeight, pfxRect.x, pfxRect.y, pfxRect.width, pfxRect.height) ||
+            !pfxRect.intersect(sector.visibleRect))
         {
-          particles.getVertexArray(pfxBuffer, dx, dy);
-          sg_append_buffer(pfx_vertex, sg_range{ .ptr = pfxBuffer.data(), .size = pfxCount * PFX_VERTEX_SIZE * 4});
-          particleCount += pfxCount;
+          light.particles.updateTime(app_time);
+          continue;
         }
+        pfxDraws.push_back(PFXDraw{ &light.particles, 0, 0 });
       }
     }
     else
@@ -427,13 +784,83 @@ void App::DrawFrame() {
     }
   }
 
-  if (particleCount > 0)
+  // The systems are independent, so update (and sort) them in parallel
+  vec3 depthAxis(mv[0][2], mv[1][2], mv[2][2]);
+  jobSystem.parallelFor((uint32_t)pfxDraws.size(), [this, &depthAxis](uint32_t i) {
+    pfxDraws[i].particles->update(app_time);
+    if (pfxDepthSort)
+    {
+      pfxDraws[i].particles->depthSort(camPos, depthAxis);
+    }
+  });
+
+  // Give each system its own range of the staging buffer
+  uint32_t particleCount = 0;
+  for (PFXDraw& draw : pfxDraws)
+  {
+    uint32_t pfxCount = draw.particles->getParticleCount();
+    if (pfxCount > MAX_PFX_PARTICLES)
+    {
+      pfxCount = MAX_PFX_PARTICLES;
+    }
+    if ((particleCount + pfxCount) > MAX_TOTAL_PARTICLES)
+    {
+      pfxCount = MAX_TOTAL_PARTICLES - particleCount;
+    }
+
+    draw.offset = particleCount;
+    draw.count = pfxCount;
+    particleCount += pfxCount;
+  }
+
+  if (particleCount > 0 && pfxInstanced)
   {
+    // Fill the position/size and color streams of the staging buffer in parallel, then upload them once
+    pfxBuffer.resize(size_t(particleCount) * PFX_INSTANCE_SIZE);
+    vec4* posAndSize = (vec4*)pfxBuffer.data();
+    vec4* colors = posAndSize + particleCount;
+    jobSystem.parallelFor((uint32_t)pfxDraws.size(), [this, posAndSize, colors](uint32_t i) {
+      const PFXDraw& draw = pfxDraws[i];
+      if (draw.count > 0)
+      {
+        draw.particles->fillInstanceVertexArrayRange(posAndSize + draw.offset, colors + draw.offset, 0, draw.count);
+      }
+    });
+    int offset = sg_append_buffer(pfx_vertex, sg_range{ .ptr = pfxBuffer.data(), .size = pfxBuffer.size() });
+
+    sg_apply_pipeline(pfx_inst_pipline);
+    sg_apply_uniforms(SG_SHADERSTAGE_VS, SLOT_vs_params_pfx_inst, SG_RANGE_REF(pfx_inst_params));
+    sg_bindings binding = {};
+    binding.index_buffer = pfx_index;
+    binding.vertex_buffers[0] = pfx_corners;
+    binding.vertex_buffers[1] = pfx_vertex;
+    binding.vertex_buffer_offsets[1] = offset;
+    binding.vertex_buffers[2] = pfx_vertex;
+    binding.vertex_buffer_offsets[2] = offset + int(particleCount * sizeof(vec4));
+    binding.fs.images[0] = pfx_particle;
+    binding.fs.samplers[0] = pfx_smp;
+    sg_apply_bindings(&binding);
+    sg_draw(0, 6, particleCount);
+  }
+  else if (particleCount > 0)
+  {
+    // Fill the staging buffer in parallel, then upload it once
+    pfxBuffer.resize(size_t(particleCount) * PFX_VERTEX_SIZE * 4);
+    jobSystem.parallelFor((uint32_t)pfxDraws.size(), [this, &dx, &dy](uint32_t i) {
+      const PFXDraw& draw = pfxDraws[i];
+      if (draw.count > 0)
+      {
+        draw.particles->fillVertexArrayRange(pfxBuffer.data() + size_t(draw.offset) * PFX_VERTEX_SIZE * 4, dx, dy, 0, draw.count);
+      }
+    });
+    int offset = sg_append_buffer(pfx_vertex, sg_range{ .ptr = pfxBuffer.data(), .size = pfxBuffer.size() });
+
     sg_apply_pipeline(pfx_pipline);
     sg_apply_uniforms(SG_SHADERSTAGE_VS, 0, SG_RANGE_REF(pfx_params));
     sg_bindings binding = {};
     binding.index_buffer = pfx_index;
     binding.vertex_buffers[0] = pfx_vertex;
+    binding.vertex_buffer_offsets[0] = offset;
     binding.fs.images[0] = pfx_particle;
     binding.fs.samplers[0] = pfx_smp;
     sg_apply_bindings(&binding);
@@ -445,5 +872,9 @@ void App::DrawFrame() {
 #endif //SOKOL_GL
 
   sg_end_pass();
+
+  // Prefetch the textures of sectors near the camera sector, then process the texture loads for the frame
+  PrefetchSectorTextures(currSector);
+  textureStreamer.update();
 }
 
@@ -4,32 +4,38 @@
 #include "framework/BaseApp.h"
 #include "framework/ParticleSystem.h"
 #include "framework/Model.h"
+#include "framework/AABBGrid.h"
+#include "framework/Level.h"
+#include "framework/JobSystem.h"
+#include "framework/TextureStreamer.h"
+#include "framework/DrawList.h"
 
 
 struct Light {
 
-  Light(vec3 in_position, float in_radius,float in_xs, float in_ys, float in_zs)
-  : position(in_position)
-  , radius(in_radius)
-  , xs(in_xs)
-  , ys(in_ys)
-  , zs(in_zs)
+  Light(const LevelLight& in_light, uint32_t seed)
+  : position(glm::make_vec3(in_light.position))
+  , radius(in_light.radius)
+  , xs(in_light.offsetScale[0])
+  , ys(in_light.offsetScale[1])
+  , zs(in_light.offsetScale[2])
   {
-    particles.setSpawnRate(400);
-    particles.setSpeed(70, 20);
-    particles.setLife(3.0f, 0);
-    particles.setDirectionalForce(vec3(0, -10, 0));
-    particles.setFrictionFactor(0.95f);
+    const LevelParticles& params = in_light.particles;
+    particles.setSpawnRate(params.spawnRate);
+    particles.setSpeed(params.speed, params.speedSpread);
+    particles.setLife(params.life, params.lifeSpread);
+    particles.setDirectionalForce(glm::make_vec3(params.directionalForce));
+    particles.setFrictionFactor(params.frictionFactor);
     //particles.setPosition(pos);
-    particles.setSize(15, 5);
+    particles.setSize(params.size, params.sizeSpread);
+    particles.setSeed(seed); // Fixed per light so runs are reproducible
 
-    for (unsigned int i = 0; i < 6; i++) {
-      particles.setColor(i, vec4(0.05f * i, 0.01f * i, 0, 0));
-      particles.setColor(6 + i, vec4(0.05f * 6, 0.05f * i + 0.06f, 0.02f * i, 0));
+    for (unsigned int i = 0; i < 12; i++) {
+      particles.setColor(i, glm::make_vec4(params.colors[i]));
     }
   }
 
-  vec3 CalcLightOffset(float t, float j)
+  vec3 CalcLightOffset(float t, float j) const
   {
     return vec3(xs * cosf(4.23f * t + j), ys * sinf(2.37f * t) * cosf(1.39f * t), zs * sinf(3.12f * t + j));
   }
@@ -40,6 +46,64 @@ struct Light {
   float xs = 0.0f, ys = 0.0f, zs = 0.0f;
 };
 
+// Light of another sector that can reach into a sector through a portal
+struct SectorLightRef {
+  uint32_t sector = 0;
+  uint32_t light = 0;
+};
+
+// Light that reaches the visible part of the sector being drawn
+struct VisibleLight {
+  vec3 position;
+  float radius = 0.0f;
+};
+
+// Visible particle system of a frame, written to its own range of the particle staging buffer
+struct PFXDraw {
+  ParticleSystem* particles = nullptr;
+  uint32_t offset = 0; // First particle in the staging buffer
+  uint32_t count = 0;
+};
+
+struct ScreenRect {
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+
+  // Clip to the passed rectangle, returns false if the resulting area is empty
+  inline bool intersect(const ScreenRect& other) {
+    uint32_t endX = min(x + width, other.x + other.width);
+    uint32_t endY = min(y + height, other.y + other.height);
+    x = max(x, other.x);
+    y = max(y, other.y);
+    if (x >= endX || y >= endY) {
+      width = 0;
+      height = 0;
+      return false;
+    }
+    width = endX - x;
+    height = endY - y;
+    return true;
+  }
+
+  inline bool contains(const ScreenRect& other) const {
+    return (other.x >= x && other.y >= y &&
+            other.x + other.width <= x + width &&
+            other.y + other.height <= y + height);
+  }
+
+  // Grow to the bounds of this and the passed rectangle
+  inline void merge(const ScreenRect& other) {
+    uint32_t endX = max(x + width, other.x + other.width);
+    uint32_t endY = max(y + height, other.y + other.height);
+    x = min(x, other.x);
+    y = min(y, other.y);
+    width = endX - x;
+    height = endY - y;
+  }
+};
+
 struct Portal {
   inline Portal(uint32_t sect, const vec3& vc0, const vec3& vc1, const vec3& vc2) {
     sector = sect;
@@ -56,7 +120,7 @@ struct Portal {
 class Sector {
 public:
 
-  inline bool isInBoundingBox(vec3& pos) const {
+  inline bool isInBoundingBox(const vec3& pos) const {
     return (pos.x > min.x && pos.x < max.x&&
       pos.y > min.y && pos.y < max.y&&
       pos.z > min.z && pos.z < max.z);
@@ -82,46 +146,103 @@ public:
   }
 
 
+  // Store the portal corners as a structure of arrays for batched transforms (one vec4 of corner x/y/z values per portal)
+  inline void updatePortalCorners() {
+    portalX.resize(portals.size());
+    portalY.resize(portals.size());
+    portalZ.resize(portals.size());
+    for (size_t i = 0; i < portals.size(); i++) {
+      const Portal& portal = portals[i];
+      portalX[i] = vec4(portal.v[0].x, portal.v[1].x, portal.v[2].x, portal.v[3].x);
+      portalY[i] = vec4(portal.v[0].y, portal.v[1].y, portal.v[2].y, portal.v[3].y);
+      portalZ[i] = vec4(portal.v[0].z, portal.v[1].z, portal.v[2].z, portal.v[3].z);
+    }
+  }
+
   Model room;
   std::vector<Portal> portals;
+  std::vector<vec4> portalX;
+  std::vector<vec4> portalY;
+  std::vector<vec4> portalZ;
   std::vector<Light> lights;
+  std::vector<SectorLightRef> portalLights; // Lights of neighbouring sectors that reach in through a portal
+
+  std::vector<uint32_t> baseTextures; // Streamed texture ids per batch
+  std::vector<uint32_t> bumpTextures;
 
   vec3 min, max;
-  bool hasBeenDrawn = false;
+  std::vector<vec3> batchMin; // Bounds of each batch of the room, for light culling
+  std::vector<vec3> batchMax;
+  uint32_t streamDistance = 0; // Portals from the camera sector, used while prefetching textures
+  bool hasBeenDrawn = false; // Visible through the portals this frame
+  ScreenRect visibleRect; // Bounds of the screen areas of all portals the sector is seen through, valid if hasBeenDrawn
+  uint32_t portalDepth = 0; // Portals from the camera sector, valid if hasBeenDrawn
+  bool isQueued = false; // Waiting to have its portals walked (see FindVisibleSectors)
 };
 
 class App : public BaseApp
 {
 public:
 
+  bool OnEvent(const sapp_event* ev) override;
   void ResetCamera() override;
   bool Load() override;
   void DrawFrame() override;
 
 protected:
 
-  Sector sectors[5];
+  uint32_t FindSector(const vec3& pos);
+  void DrawSector(uint32_t sectorIndex, const ScreenRect& rect);
+  void GatherSectorLights(uint32_t sectorIndex);
+  void FindVisibleSectors(uint32_t startSector, const ScreenRect& rect);
+  void RequestSectorTextures(uint32_t sectorIndex, uint32_t priority);
+  void PrefetchSectorTextures(uint32_t startSector);
+
+  std::vector<Sector> sectors;
+  AABBGrid sectorGrid;
+  uint32_t currSector = 0;
+
+  mat4 viewProj = mat4(1.0f);
+  vec4 frustumPlanes[6] = {}; // World space, normalized
+  uint32_t screenWidth = 0;
+  uint32_t screenHeight = 0;
 
   sg_sampler smp;
 
   sg_shader shader = {};
-  sg_image base[3] = {};
-  sg_image bump[3] = {};
   sg_pipeline room_pipline = {};
   sg_pipeline room_pipline_blend = {};
+  sg_shader lights_shader = {};
+  sg_pipeline room_lights_pipline = {};
+  bool singlePassLighting = true; // All lights of a sector in one pass, or one pass per light (toggled with L)
 
   sg_sampler pfx_smp;
   sg_shader pfx_shader = {};
   sg_image pfx_particle = {};
   sg_pipeline pfx_pipline = {};
+  sg_shader pfx_inst_shader = {};
+  sg_pipeline pfx_inst_pipline = {};
 
   sg_buffer pfx_index = {};
   sg_buffer pfx_vertex = {};
+  sg_buffer pfx_corners = {};
+  bool pfxInstanced = true; // Instanced billboards, or expanded on the CPU (toggled with I)
+  bool pfxDepthSort = false; // Sort the particles by distance each frame, not needed for the additive blending (toggled with P)
+
+  std::vector<vec4> portalClipPoints; // Portal corners of the sector being walked
+  std::vector<uint32_t> portalOutcodes;
+  std::vector<uint32_t> visibleQueue; // Sectors to walk the portals of (a sector is queued again when its visible area grows)
+  std::vector<VisibleLight> sectorLights; // Lights of the sector being drawn
+  std::vector<uint8_t> batchVisible; // Frustum test result of each batch of the sector being drawn
+  DrawList drawList; // Room draws of the frame
+  bool showDrawStats = false; // Applied and skipped state changes of the draw list in the window title (toggled with T)
 
   std::vector<uint8_t> pfxBuffer;
-  std::vector<uint8_t> loadBuffer;
-  std::vector<vec4> workingBuffer1;
-  std::vector<vec4> workingBuffer2;
+  std::vector<PFXDraw> pfxDraws;
+
+  JobSystem jobSystem;
+  TextureStreamer textureStreamer; // Destroyed before the job system (waits on its loads)
+  std::vector<uint32_t> streamQueue;
 
 };
 
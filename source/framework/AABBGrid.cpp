@@ -0,0 +1,159 @@
+#include "AABBGrid.h"
+
+const uint32_t MAX_GRID_CELLS_PER_AXIS = 128;
+
+void AABBGrid::clear() {
+  boxMin.resize(0);
+  boxMax.resize(0);
+  cellStart.resize(0);
+  cellBoxes.resize(0);
+  cellCount[0] = cellCount[1] = cellCount[2] = 0;
+}
+
+void AABBGrid::addBox(const vec3& a_min, const vec3& a_max) {
+  boxMin.push_back(a_min);
+  boxMax.push_back(a_max);
+}
+
+void AABBGrid::getCellCoords(const vec3& a_point, uint32_t o_coords[3]) const {
+  vec3 cell = (a_point - gridMin) * invCellSize;
+  for (uint32_t i = 0; i < 3; i++) {
+    float c = clamp(cell[i], 0.0f, float(cellCount[i] - 1));
+    o_coords[i] = (uint32_t)c;
+  }
+}
+
+void AABBGrid::build(float a_boxesPerCell) {
+  cellStart.resize(0);
+  cellBoxes.resize(0);
+  if (boxMin.size() == 0) {
+    cellCount[0] = cellCount[1] = cellCount[2] = 0;
+    return;
+  }
+
+  // Get the total bounds
+  vec3 gridMax = vec3(-FLT_MAX);
+  gridMin = vec3(FLT_MAX);
+  for (size_t i = 0; i < boxMin.size(); i++) {
+    gridMin = min(gridMin, boxMin[i]);
+    gridMax = max(gridMax, boxMax[i]);
+  }
+
+  // Pick a cubic cell size so there is roughly the requested number of boxes per cell
+  vec3 extents = max(gridMax - gridMin, vec3(1.0f));
+  float targetCells = max(float(boxMin.size()) / a_boxesPerCell, 1.0f);
+  float cellSize = cbrtf((extents.x * extents.y * extents.z) / targetCells);
+  for (uint32_t i = 0; i < 3; i++) {
+    float count = ceilf(extents[i] / cellSize);
+    cellCount[i] = (uint32_t)clamp(count, 1.0f, float(MAX_GRID_CELLS_PER_AXIS));
+    invCellSize[i] = float(cellCount[i]) / extents[i];
+  }
+
+  // Count the boxes per cell, then fill (compact cell lists)
+  uint32_t totalCells = cellCount[0] * cellCount[1] * cellCount[2];
+  cellStart.resize(totalCells + 1, 0);
+
+  auto for_each_cell = [&](size_t box, auto&& func) {
+    uint32_t start[3];
+    uint32_t end[3];
+    getCellCoords(boxMin[box], start);
+    getCellCoords(boxMax[box], end);
+    for (uint32_t z = start[2]; z <= end[2]; z++) {
+      for (uint32_t y = start[1]; y <= end[1]; y++) {
+        for (uint32_t x = start[0]; x <= end[0]; x++) {
+          func(getCellIndex(x, y, z));
+        }
+      }
+    }
+  };
+
+  for (size_t i = 0; i < boxMin.size(); i++) {
+    for_each_cell(i, [&](uint32_t cell) { cellStart[cell + 1]++; });
+  }
+  for (uint32_t i = 0; i < totalCells; i++) {
+    cellStart[i + 1] += cellStart[i];
+  }
+
+  std::vector<uint32_t> fillOffset(cellStart.begin(), cellStart.end() - 1);
+  cellBoxes.resize(cellStart[totalCells]);
+  for (size_t i = 0; i < boxMin.size(); i++) {
+    for_each_cell(i, [&](uint32_t cell) { cellBoxes[fillOffset[cell]++] = (uint32_t)i; });
+  }
+}
+
+uint32_t AABBGrid::getCellBoxes(const vec3& a_point, const uint32_t*& o_boxes) const {
+  o_boxes = nullptr;
+  if (cellStart.size() == 0) {
+    return 0;
+  }
+
+  uint32_t coords[3];
+  getCellCoords(a_point, coords);
+  uint32_t cell = getCellIndex(coords[0], coords[1], coords[2]);
+
+  o_boxes = cellBoxes.data() + cellStart[cell];
+  return cellStart[cell + 1] - cellStart[cell];
+}
+
+static float get_box_distance_sqr(const vec3& a_point, const vec3& a_min, const vec3& a_max) {
+  vec3 d = max(max(a_min - a_point, a_point - a_max), vec3(0.0f));
+  return dot(d, d);
+}
+
+bool AABBGrid::findNearestBox(const vec3& a_point, uint32_t& o_box, float& o_distanceSqr) const {
+  if (cellStart.size() == 0) {
+    return false;
+  }
+
+  uint32_t coords[3];
+  getCellCoords(a_point, coords);
+  int center[3] = { (int)coords[0], (int)coords[1], (int)coords[2] };
+  int maxRing = 0;
+  for (uint32_t i = 0; i < 3; i++) {
+    maxRing = max(maxRing, max(center[i], (int)cellCount[i] - 1 - center[i]));
+  }
+
+  o_distanceSqr = FLT_MAX;
+  for (int ring = 0; ring <= maxRing; ring++) {
+
+    // Boxes in the cells of the ring (boxes over several cells may be checked more than once)
+    for (int z = max(center[2] - ring, 0); z <= min(center[2] + ring, (int)cellCount[2] - 1); z++) {
+      for (int y = max(center[1] - ring, 0); y <= min(center[1] + ring, (int)cellCount[1] - 1); y++) {
+        bool inner = (abs(z - center[2]) < ring && abs(y - center[1]) < ring);
+        int xStep = inner ? 2 * ring : 1;
+        for (int x = center[0] - ring; x <= center[0] + ring; x += xStep) {
+          if (x < 0 || x >= (int)cellCount[0]) {
+            continue;
+          }
+          uint32_t cell = getCellIndex(x, y, z);
+          for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+            uint32_t box = cellBoxes[i];
+            float distanceSqr = get_box_distance_sqr(a_point, boxMin[box], boxMax[box]);
+            if (distanceSqr < o_distanceSqr) {
+              o_distanceSqr = distanceSqr;
+              o_box = box;
+            }
+          }
+        }
+      }
+    }
+
+    // Boxes not found yet are all in cells outside the rings searched, so are at least as far as the nearest side of the rings
+    float ringDistance = FLT_MAX;
+    for (uint32_t i = 0; i < 3; i++) {
+      float cellSize = 1.0f / invCellSize[i];
+      if (center[i] - ring > 0) {
+        float side = gridMin[i] + float(center[i] - ring) * cellSize;
+        ringDistance = min(ringDistance, max(a_point[i] - side, 0.0f));
+      }
+      if (center[i] + ring + 1 < (int)cellCount[i]) {
+        float side = gridMin[i] + float(center[i] + ring + 1) * cellSize;
+        ringDistance = min(ringDistance, max(side - a_point[i], 0.0f));
+      }
+    }
+    if (ringDistance == FLT_MAX || o_distanceSqr <= ringDistance * ringDistance) {
+      break;
+    }
+  }
+  return o_distanceSqr != FLT_MAX;
+}
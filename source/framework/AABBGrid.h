@@ -0,0 +1,44 @@
+#ifndef _AABB_GRID_H_
+#define _AABB_GRID_H_
+
+#include "Vector.h"
+#include <vector>
+
+// Uniform grid over a set of axis aligned bounding boxes, used to quickly find the boxes near a point.
+// Boxes are referenced by the order they were added.
+class AABBGrid
+{
+public:
+
+  void clear();
+  void addBox(const vec3& a_min, const vec3& a_max);
+
+  // Build the grid cells (call after all boxes are added)
+  void build(float a_boxesPerCell = 1.0f);
+
+  // Get the boxes that overlap the grid cell the point is in (the point is clamped to the grid bounds)
+  uint32_t getCellBoxes(const vec3& a_point, const uint32_t*& o_boxes) const;
+
+  // Get the box nearest to the point (squared distance 0 when inside a box) by searching rings of cells around it,
+  // until the ring is further away than the nearest box found. Returns false if there are no boxes.
+  bool findNearestBox(const vec3& a_point, uint32_t& o_box, float& o_distanceSqr) const;
+
+  inline uint32_t getBoxCount() const { return (uint32_t)boxMin.size(); }
+
+protected:
+
+  uint32_t getCellIndex(uint32_t a_x, uint32_t a_y, uint32_t a_z) const { return (a_z * cellCount[1] + a_y) * cellCount[0] + a_x; }
+  void getCellCoords(const vec3& a_point, uint32_t o_coords[3]) const;
+
+  std::vector<vec3> boxMin;
+  std::vector<vec3> boxMax;
+
+  vec3 gridMin = vec3(0.0f);
+  vec3 invCellSize = vec3(0.0f);
+  uint32_t cellCount[3] = { 0, 0, 0 };
+
+  std::vector<uint32_t> cellStart; // Start offset of each cell into cellBoxes (cell count + 1 entries)
+  std::vector<uint32_t> cellBoxes;
+};
+
+#endif // _AABB_GRID_H_
@@ -3,6 +3,7 @@
 #include "external/sokol_app.h"
 #include "external/sokol_glue.h"
 #include "external/sokol_time.h"
+#include <stdio.h>
 
 
 #ifdef _DEBUG
@@ -147,12 +148,21 @@ static void init_userdata_cb(void* in_app) {
   sgl_setup(sgl_desc_t{});
 #endif // SOKOL_GL
   //DT_TODO: Load UI assets
-  app->Load();
+  if (!app->Load()) {
+    // Nothing can be drawn without the app data, so quit
+    printf("Failed to load the app data\n");
+    sapp_quit();
+    return;
+  }
+  app->isLoaded = true;
   app->ResetCamera();
 }
 
 static void frame_userdata_cb(void* in_app) {
   BaseApp* app = (BaseApp*)in_app;
+  if (!app->isLoaded) {
+    return;
+  }
   
   // Update delta time
   app->frame_time = (float)stm_sec(stm_laptime(&app->time_ticks));
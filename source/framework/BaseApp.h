@@ -26,6 +26,7 @@ public:
 
   void Controls();
  
+  bool isLoaded = false; // Load succeeded, frames are only drawn once loaded
   float app_time = 0.0f;
   float frame_time = 0.0f;
   uint64_t start_ticks = 0;
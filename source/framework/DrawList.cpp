@@ -0,0 +1,111 @@
+#include "DrawList.h"
+#include <algorithm>
+#include <string.h>
+
+const uint32_t UNIFORM_ALIGNMENT = 16;
+
+uint64_t make_draw_key(uint32_t layer, sg_pipeline pipeline, sg_image image0, sg_image image1, sg_buffer vertexBuffer) {
+  return (uint64_t(layer & 0xF) << 60) |
+         (uint64_t(pipeline.id & 0xFFF) << 48) |
+         (uint64_t(image0.id & 0xFFFF) << 32) |
+         (uint64_t(image1.id & 0xFFFF) << 16) |
+         uint64_t(vertexBuffer.id & 0xFFFF);
+}
+
+void DrawList::reset() {
+  commands.clear();
+  uniformBlocks.clear();
+  uniformData.clear();
+}
+
+uint32_t DrawList::addUniforms(const void* data, uint32_t size) {
+  uint32_t offset = (uint32_t(uniformData.size()) + UNIFORM_ALIGNMENT - 1) & ~(UNIFORM_ALIGNMENT - 1);
+  uniformData.resize(size_t(offset) + size);
+  memcpy(uniformData.data() + offset, data, size);
+  uniformBlocks.push_back(UniformBlock{ offset, size });
+  return uint32_t(uniformBlocks.size() - 1);
+}
+
+bool DrawList::applyUniforms(sg_shader_stage stage, uint32_t handle, uint32_t& currHandle) {
+  if (handle == DRAW_NO_UNIFORMS) {
+    return false;
+  }
+
+  // Different blocks can hold the same values (eg. the camera constants of each sector)
+  const UniformBlock& block = uniformBlocks[handle];
+  if (currHandle != DRAW_NO_UNIFORMS) {
+    const UniformBlock& curr = uniformBlocks[currHandle];
+    if (handle == currHandle ||
+        (block.size == curr.size && memcmp(uniformData.data() + block.offset, uniformData.data() + curr.offset, block.size) == 0)) {
+      return false;
+    }
+  }
+
+  sg_apply_uniforms(stage, 0, sg_range{ .ptr = uniformData.data() + block.offset, .size = block.size });
+  currHandle = handle;
+  return true;
+}
+
+void DrawList::submit() {
+
+  stats = DrawListStats();
+
+  sortEntries.resize(commands.size());
+  for (uint32_t i = 0; i < (uint32_t)commands.size(); i++) {
+    sortEntries[i] = SortEntry{ commands[i].key, i };
+  }
+  std::sort(sortEntries.begin(), sortEntries.end(), [](const SortEntry& a, const SortEntry& b) {
+    return (a.key != b.key) ? (a.key < b.key) : (a.index < b.index);
+  });
+
+  // Applying a pipeline invalidates the bindings and uniforms, so they are always applied after a pipeline change
+  uint32_t currPipeline = SG_INVALID_ID;
+  const DrawCommand* currBindings = nullptr;
+  const DrawCommand* currScissor = nullptr;
+  uint32_t currVsUniforms = DRAW_NO_UNIFORMS;
+  uint32_t currFsUniforms = DRAW_NO_UNIFORMS;
+  for (const SortEntry& entry : sortEntries) {
+    const DrawCommand& command = commands[entry.index];
+
+    if (command.pipeline.id != currPipeline) {
+      sg_apply_pipeline(command.pipeline);
+      currPipeline = command.pipeline.id;
+      currBindings = nullptr;
+      currVsUniforms = DRAW_NO_UNIFORMS;
+      currFsUniforms = DRAW_NO_UNIFORMS;
+      stats.pipelines++;
+    }
+    else {
+      stats.pipelinesSkipped++;
+    }
+
+    if (currBindings == nullptr || memcmp(&currBindings->bindings, &command.bindings, sizeof(sg_bindings)) != 0) {
+      sg_apply_bindings(&command.bindings);
+      currBindings = &command;
+      stats.bindings++;
+    }
+    else {
+      stats.bindingsSkipped++;
+    }
+
+    uint32_t uniformBlocksUsed = (command.vsUniforms != DRAW_NO_UNIFORMS ? 1 : 0) + (command.fsUniforms != DRAW_NO_UNIFORMS ? 1 : 0);
+    uint32_t uniformsApplied = (applyUniforms(SG_SHADERSTAGE_VS, command.vsUniforms, currVsUniforms) ? 1 : 0) +
+                               (applyUniforms(SG_SHADERSTAGE_FS, command.fsUniforms, currFsUniforms) ? 1 : 0);
+    stats.uniforms += uniformsApplied;
+    stats.uniformsSkipped += uniformBlocksUsed - uniformsApplied;
+
+    if (currScissor == nullptr ||
+        currScissor->scissorX != command.scissorX || currScissor->scissorY != command.scissorY ||
+        currScissor->scissorWidth != command.scissorWidth || currScissor->scissorHeight != command.scissorHeight) {
+      sg_apply_scissor_rect(command.scissorX, command.scissorY, command.scissorWidth, command.scissorHeight, true);
+      currScissor = &command;
+      stats.scissors++;
+    }
+    else {
+      stats.scissorsSkipped++;
+    }
+
+    sg_draw(command.baseElement, command.numElements, command.numInstances);
+    stats.draws++;
+  }
+}
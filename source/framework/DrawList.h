@@ -0,0 +1,85 @@
+#ifndef _DRAW_LIST_H_
+#define _DRAW_LIST_H_
+
+#include "external/sokol_gfx.h"
+#include <stdint.h>
+#include <vector>
+
+const uint32_t DRAW_NO_UNIFORMS = UINT32_MAX;
+
+// Sort key of a draw: layer (4 bits), pipeline (12 bits), first two fragment images and first vertex buffer (16 bits each).
+// Layers are drawn in order, so draws that depend on earlier ones (eg. additive light passes) go in a later layer.
+// Only the pool slot part of the sokol ids is used, which is unique while the resource is alive.
+uint64_t make_draw_key(uint32_t layer, sg_pipeline pipeline, sg_image image0, sg_image image1, sg_buffer vertexBuffer);
+
+struct DrawCommand {
+  uint64_t key = 0;
+  sg_pipeline pipeline = {};
+  sg_bindings bindings = {};
+  uint32_t vsUniforms = DRAW_NO_UNIFORMS; // Uniform block 0 of each stage, handles from DrawList::addUniforms
+  uint32_t fsUniforms = DRAW_NO_UNIFORMS;
+  uint32_t scissorX = 0;
+  uint32_t scissorY = 0;
+  uint32_t scissorWidth = 0;
+  uint32_t scissorHeight = 0;
+  int baseElement = 0;
+  int numElements = 0;
+  int numInstances = 1;
+};
+
+// Applied and skipped (same as the current state) sokol calls of the last submit
+struct DrawListStats {
+  uint32_t draws = 0;
+  uint32_t pipelines = 0;
+  uint32_t pipelinesSkipped = 0;
+  uint32_t bindings = 0;
+  uint32_t bindingsSkipped = 0;
+  uint32_t uniforms = 0;
+  uint32_t uniformsSkipped = 0;
+  uint32_t scissors = 0;
+  uint32_t scissorsSkipped = 0;
+};
+
+// Draws recorded over a frame, then sorted by key and submitted with redundant state changes skipped.
+// Draws with the same key are submitted in the order they were recorded.
+class DrawList
+{
+public:
+
+  void reset();
+
+  // Copy a uniform block for the draws of this frame
+  uint32_t addUniforms(const void* data, uint32_t size);
+  template<typename T>
+  inline uint32_t addUniforms(const T& data) { return addUniforms(&data, uint32_t(sizeof(T))); }
+
+  inline void draw(const DrawCommand& command) { commands.push_back(command); }
+
+  // Must be called inside a pass. The scissor rect is left as set by the last draw.
+  void submit();
+
+  inline const DrawListStats& getStats() const { return stats; }
+  inline uint32_t getCommandCount() const { return (uint32_t)commands.size(); }
+
+protected:
+
+  struct UniformBlock {
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  struct SortEntry {
+    uint64_t key;
+    uint32_t index; // Record order, keeps the sort stable
+  };
+
+  bool applyUniforms(sg_shader_stage stage, uint32_t handle, uint32_t& currHandle);
+
+  std::vector<DrawCommand> commands;
+  std::vector<SortEntry> sortEntries;
+  std::vector<UniformBlock> uniformBlocks;
+  std::vector<uint8_t> uniformData;
+  DrawListStats stats;
+};
+
+#endif // _DRAW_LIST_H_
@@ -1,13 +1,13 @@
 #include "Image.h"
+#include "Vector.h"
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
 
 #define STBI_ONLY_PNG
 #define STB_IMAGE_IMPLEMENTATION
 #include "external/stb_image.h"
 
-bool is_power2(unsigned int v) {
-  return v && ((v & (v - 1)) == 0);
-}
-
 int get_mipmap_count(int width, int height) {
   int max = (width > height) ? width : height;
   int i = 0;
@@ -20,60 +20,484 @@ int get_mipmap_count(int width, int height) {
   return i;
 }
 
-void build_mipmapRGBA8(uint8_t* dest, uint8_t* src, int width, int height) {
-  int xOff = (width < 2) ? 0 : 4;
-  int yOff = (height < 2) ? 0 : width * 4;
+// Generic box filter, each destination texel averages a 2x2 block (3 wide/high on the last column/row of odd sizes)
+template <typename Filter>
+void build_mipmap_box(uint8_t* dest, const uint8_t* src, int width, int height, int startX, Filter& filter) {
+  int newWidth = (width > 1) ? width >> 1 : 1;
+  int newHeight = (height > 1) ? height >> 1 : 1;
+
+  for (int y = 0; y < newHeight; y++) {
+    int y0 = (height > 1) ? y * 2 : 0;
+    int yCount = (height == 1) ? 1 : ((y == newHeight - 1 && (height & 1)) ? 3 : 2);
 
-  for (int y = 0; y < height; y += 2) {
-    for (int x = 0; x < width; x += 2) {
-      for (int i = 0; i < 4; i++) {
-        *dest = ((src[0] + src[xOff] + src[yOff] + src[yOff + xOff]) + 2) >> 2;
-        dest++;
-        src++;
+    for (int x = startX; x < newWidth; x++) {
+      int x0 = (width > 1) ? x * 2 : 0;
+      int xCount = (width == 1) ? 1 : ((x == newWidth - 1 && (width & 1)) ? 3 : 2);
+
+      filter.begin();
+      for (int sy = 0; sy < yCount; sy++) {
+        const uint8_t* row = src + (size_t(y0 + sy) * width + x0) * 4;
+        for (int sx = 0; sx < xCount; sx++) {
+          filter.add(row + sx * 4);
+        }
       }
-      src += xOff;
+      filter.end(dest + (size_t(y) * newWidth + x) * 4, xCount * yCount);
     }
-    src += yOff;
   }
 }
 
-sg_image create_texture(const char* filename, std::vector<uint8_t>& loadbuffer, bool useMipmaps) {
+struct LinearFilter {
+  uint32_t sum[4];
+  inline void begin() { sum[0] = sum[1] = sum[2] = sum[3] = 0; }
+  inline void add(const uint8_t* src) {
+    for (int i = 0; i < 4; i++) sum[i] += src[i];
+  }
+  inline void end(uint8_t* dest, uint32_t count) {
+    for (int i = 0; i < 4; i++) dest[i] = uint8_t((sum[i] + count / 2) / count);
+  }
+};
 
-  sg_image_desc local_desc = {};
-  int texN = 0;
-  uint8_t* texData = stbi_load(filename, &local_desc.width, &local_desc.height, &texN, 4);
-  if (texData == nullptr) {
-    return sg_image{};
+struct SRGBTables {
+  float toLinear[256];
+  uint8_t toSRGB[4096]; // Indexed by linear value * 4095
+
+  SRGBTables() {
+    for (int i = 0; i < 256; i++) {
+      float c = i / 255.0f;
+      toLinear[i] = (c <= 0.04045f) ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+    }
+    for (int i = 0; i < 4096; i++) {
+      float c = i / 4095.0f;
+      c = (c <= 0.0031308f) ? c * 12.92f : 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+      toSRGB[i] = uint8_t(c * 255.0f + 0.5f);
+    }
+  }
+};
+
+struct SRGBFilter {
+  const SRGBTables& tables;
+  float color[3];
+  uint32_t alpha;
+
+  inline void begin() { color[0] = color[1] = color[2] = 0.0f; alpha = 0; }
+  inline void add(const uint8_t* src) {
+    for (int i = 0; i < 3; i++) color[i] += tables.toLinear[src[i]];
+    alpha += src[3];
+  }
+  inline void end(uint8_t* dest, uint32_t count) {
+    float scale = 4095.0f / count;
+    for (int i = 0; i < 3; i++) dest[i] = tables.toSRGB[int(color[i] * scale + 0.5f)];
+    dest[3] = uint8_t((alpha + count / 2) / count);
+  }
+};
+
+// Map a normal component from [-1, 1] to [0, 255] (rounded), used for both the generated normal maps and their mipmaps
+static inline uint8_t encode_normal(float value) {
+  return uint8_t(value * 127.5f + 127.5f + 0.5f);
+}
+
+struct NormalFilter {
+  vec3 normal;
+  uint32_t alpha;
+  inline void begin() { normal = vec3(0.0f); alpha = 0; }
+  inline void add(const uint8_t* src) {
+    normal += vec3(src[0], src[1], src[2]) * (2.0f / 255.0f) - 1.0f;
+    alpha += src[3];
+  }
+  inline void end(uint8_t* dest, uint32_t count) {
+    float length2 = dot(normal, normal);
+    vec3 n = (length2 > 1e-12f) ? normal * (1.0f / sqrtf(length2)) : vec3(0.0f, 0.0f, 1.0f);
+    for (int i = 0; i < 3; i++) dest[i] = encode_normal(n[i]);
+    dest[3] = uint8_t((alpha + count / 2) / count);
+  }
+};
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+// Exact (a + b + c + d + 2) >> 2 average of 2x2 blocks for 4 destination texels at a time, returns the texels done
+int build_mipmap_linear_sse2(uint8_t* dest, const uint8_t* src, int width, int height) {
+  int newWidth = width >> 1;
+  int newHeight = height >> 1;
+  int simdWidth = newWidth & ~3;
+  if (simdWidth == 0) {
+    return 0;
+  }
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi16(2);
+  for (int y = 0; y < newHeight; y++) {
+    const uint8_t* row0 = src + size_t(y * 2) * width * 4;
+    const uint8_t* row1 = row0 + size_t(width) * 4;
+    uint8_t* destRow = dest + size_t(y) * newWidth * 4;
+
+    for (int x = 0; x < simdWidth; x += 4) {
+      __m128i a0 = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+      __m128i a1 = _mm_loadu_si128((const __m128i*)(row0 + x * 8 + 16));
+      __m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+      __m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + x * 8 + 16));
+
+      // Vertical sums of texels 0,1 / 2,3 / 4,5 / 6,7 (16 bit per channel)
+      __m128i v01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+      __m128i v23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+      __m128i v45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+      __m128i v67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+      // Horizontal pairs
+      __m128i d01 = _mm_add_epi16(_mm_unpacklo_epi64(v01, v23), _mm_unpackhi_epi64(v01, v23));
+      __m128i d23 = _mm_add_epi16(_mm_unpacklo_epi64(v45, v67), _mm_unpackhi_epi64(v45, v67));
+      d01 = _mm_srli_epi16(_mm_add_epi16(d01, round), 2);
+      d23 = _mm_srli_epi16(_mm_add_epi16(d23, round), 2);
+
+      _mm_storeu_si128((__m128i*)(destRow + x * 4), _mm_packus_epi16(d01, d23));
+    }
+  }
+  return simdWidth;
+}
+
+#endif // GLM_ARCH_SSE2_BIT
+
+void build_mipmapRGBA8(uint8_t* dest, const uint8_t* src, int width, int height, MipFilter mipFilter) {
+  switch (mipFilter) {
+  case MIP_FILTER_LINEAR:
+  {
+    int startX = 0;
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    // Even sizes are done with SIMD apart from the tail of each row
+    if (width > 1 && height > 1 && (width & 1) == 0 && (height & 1) == 0) {
+      startX = build_mipmap_linear_sse2(dest, src, width, height);
+    }
+#endif
+    LinearFilter filter;
+    build_mipmap_box(dest, src, width, height, startX, filter);
+    break;
+  }
+  case MIP_FILTER_SRGB:
+  {
+    static const SRGBTables srgbTables;
+    SRGBFilter filter = { srgbTables };
+    build_mipmap_box(dest, src, width, height, 0, filter);
+    break;
+  }
+  case MIP_FILTER_NORMAL:
+  {
+    NormalFilter filter;
+    build_mipmap_box(dest, src, width, height, 0, filter);
+    break;
+  }
+  }
+}
+
+// DDS file layout (only the parts needed for block compressed 2D textures)
+const uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+const uint32_t DDS_MIPMAPCOUNT = 0x20000;
+const uint32_t DDS_PF_FOURCC = 0x4;
+
+struct DDSPixelFormat {
+  uint32_t size;
+  uint32_t flags;
+  uint32_t fourCC;
+  uint32_t rgbBitCount;
+  uint32_t rBitMask;
+  uint32_t gBitMask;
+  uint32_t bBitMask;
+  uint32_t aBitMask;
+};
+
+struct DDSHeader {
+  uint32_t size;
+  uint32_t flags;
+  uint32_t height;
+  uint32_t width;
+  uint32_t pitchOrLinearSize;
+  uint32_t depth;
+  uint32_t mipMapCount;
+  uint32_t reserved1[11];
+  DDSPixelFormat format;
+  uint32_t caps[4];
+  uint32_t reserved2;
+};
+
+struct DDSHeaderDX10 {
+  uint32_t dxgiFormat;
+  uint32_t resourceDimension;
+  uint32_t miscFlag;
+  uint32_t arraySize;
+  uint32_t miscFlags2;
+};
+
+constexpr uint32_t make_fourcc(char a, char b, char c, char d) {
+  return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+}
+
+sg_pixel_format get_dds_format(uint32_t fourCC, uint32_t dxgiFormat) {
+  switch (fourCC) {
+  case make_fourcc('D', 'X', 'T', '1'): return SG_PIXELFORMAT_BC1_RGBA;
+  case make_fourcc('D', 'X', 'T', '5'): return SG_PIXELFORMAT_BC3_RGBA;
+  case make_fourcc('A', 'T', 'I', '2'):
+  case make_fourcc('B', 'C', '5', 'U'): return SG_PIXELFORMAT_BC5_RG;
+  case make_fourcc('D', 'X', '1', '0'):
+    switch (dxgiFormat) {
+    case 71: // DXGI_FORMAT_BC1_UNORM
+    case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+      return SG_PIXELFORMAT_BC1_RGBA;
+    case 77: // DXGI_FORMAT_BC3_UNORM
+    case 78: // DXGI_FORMAT_BC3_UNORM_SRGB
+      return SG_PIXELFORMAT_BC3_RGBA;
+    case 83: // DXGI_FORMAT_BC5_UNORM
+      return SG_PIXELFORMAT_BC5_RG;
+    }
+    break;
+  }
+  return SG_PIXELFORMAT_NONE;
+}
+
+bool load_dds_image(const char* filename, ImageData& ret_image) {
+
+  if (!ret_image.file.open(filename)) {
+    return false;
+  }
+  const uint8_t* data = ret_image.file.getData();
+  size_t size = ret_image.file.getSize();
+
+  uint32_t magic = 0;
+  DDSHeader header;
+  if (size < sizeof(magic) + sizeof(header)) {
+    return false;
+  }
+  memcpy(&magic, data, sizeof(magic));
+  memcpy(&header, data + sizeof(magic), sizeof(header));
+  size_t offset = sizeof(magic) + sizeof(header);
+
+  if (magic != DDS_MAGIC ||
+      header.size != sizeof(DDSHeader) ||
+      (header.format.flags & DDS_PF_FOURCC) == 0) {
+    return false;
+  }
+
+  DDSHeaderDX10 headerDX10 = {};
+  if (header.format.fourCC == make_fourcc('D', 'X', '1', '0')) {
+    if (size < offset + sizeof(headerDX10)) {
+      return false;
+    }
+    memcpy(&headerDX10, data + offset, sizeof(headerDX10));
+    offset += sizeof(headerDX10);
+    if (headerDX10.arraySize > 1) {
+      return false;
+    }
+  }
+
+  sg_pixel_format format = get_dds_format(header.format.fourCC, headerDX10.dxgiFormat);
+  if (format == SG_PIXELFORMAT_NONE ||
+      header.width == 0 || header.height == 0 ||
+      header.width > 16384 || header.height > 16384) {
+    return false;
+  }
+  uint32_t blockSize = (format == SG_PIXELFORMAT_BC1_RGBA) ? 8 : 16;
+
+  int mip_count = ((header.flags & DDS_MIPMAPCOUNT) && header.mipMapCount > 0) ? int(header.mipMapCount) : 1;
+  int max_mips = get_mipmap_count(header.width, header.height);
+  if (mip_count > max_mips) {
+    mip_count = max_mips;
   }
+  if (mip_count > SG_MAX_MIPMAPS) {
+    mip_count = SG_MAX_MIPMAPS;
+  }
+
+  // The mip chain is stored in order after the header
+  uint32_t w = header.width;
+  uint32_t h = header.height;
+  for (int i = 0; i < mip_count; i++) {
+    size_t levelSize = size_t((w + 3) / 4) * ((h + 3) / 4) * blockSize;
+    if (offset + levelSize > size) {
+      return false;
+    }
+    ret_image.levels[i] = { .ptr = data + offset, .size = levelSize };
+    offset += levelSize;
+
+    if (w > 1) { w >>= 1; }
+    if (h > 1) { h >>= 1; }
+  }
+
+  ret_image.width = int(header.width);
+  ret_image.height = int(header.height);
+  ret_image.mipCount = mip_count;
+  ret_image.format = format;
+  return true;
+}
+
+bool has_extension(const char* filename, const char* extension) {
+  size_t nameLength = strlen(filename);
+  size_t extensionLength = strlen(extension);
+  if (nameLength < extensionLength) {
+    return false;
+  }
+  const char* end = filename + nameLength - extensionLength;
+  for (size_t i = 0; i < extensionLength; i++) {
+    if (tolower(end[i]) != extension[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Sobel filtered slopes, the normal is normalize(-dx * scale, -dy * scale, 1)
+static inline void write_normal(uint8_t* dest, int dx, int dy, uint8_t h, float scale) {
+  float nx = float(-dx) * scale;
+  float ny = float(-dy) * scale;
+  float invLength = 1.0f / sqrtf(nx * nx + ny * ny + 1.0f);
+  dest[0] = encode_normal(nx * invLength);
+  dest[1] = encode_normal(ny * invLength);
+  dest[2] = encode_normal(invLength);
+  dest[3] = h;
+}
+
+static void convert_height_row(uint8_t* dest, const uint8_t* rowUp, const uint8_t* row, const uint8_t* rowDown, int width, float scale) {
+
+  auto convert_pixel = [&](int x) {
+    int x0 = (x > 0) ? x - 1 : width - 1;
+    int x1 = (x < width - 1) ? x + 1 : 0;
+    int dx = (rowUp[x1] + 2 * row[x1] + rowDown[x1]) - (rowUp[x0] + 2 * row[x0] + rowDown[x0]);
+    int dy = (rowDown[x0] + 2 * rowDown[x] + rowDown[x1]) - (rowUp[x0] + 2 * rowUp[x] + rowUp[x1]);
+    write_normal(dest + x * 4, dx, dy, row[x], scale);
+  };
+
+  int x = 0;
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+  // 8 pixels at a time away from the wrapping edges
+  if (width > 9) {
+    convert_pixel(0);
+    x = 1;
 
-  // If bumpmap->normalmap, convert here
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 negScale = _mm_set1_ps(-scale);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 encodeScale = _mm_set1_ps(127.5f);
+    const __m128 encodeBias = _mm_set1_ps(127.5f + 0.5f); // Same as encode_normal, rounded by the truncating conversion
+
+    auto load8 = [&](const uint8_t* src) {
+      return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)src), zero);
+    };
+    auto encode = [&](__m128 value, __m128 invLength) {
+      return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(value, invLength), encodeScale), encodeBias));
+    };
+
+    for (; x + 9 <= width; x += 8) {
+      __m128i upLeft    = load8(rowUp + x - 1);
+      __m128i up        = load8(rowUp + x);
+      __m128i upRight   = load8(rowUp + x + 1);
+      __m128i left      = load8(row + x - 1);
+      __m128i right     = load8(row + x + 1);
+      __m128i downLeft  = load8(rowDown + x - 1);
+      __m128i down      = load8(rowDown + x);
+      __m128i downRight = load8(rowDown + x + 1);
+
+      __m128i dx = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(upRight, downRight), _mm_slli_epi16(right, 1)),
+                                 _mm_add_epi16(_mm_add_epi16(upLeft, downLeft), _mm_slli_epi16(left, 1)));
+      __m128i dy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(downLeft, downRight), _mm_slli_epi16(down, 1)),
+                                 _mm_add_epi16(_mm_add_epi16(upLeft, upRight), _mm_slli_epi16(up, 1)));
+
+      __m128i center = load8(row + x);
+
+      for (int half = 0; half < 2; half++) {
+        // Sign extend the 16 bit slopes to float
+        __m128i dx32 = (half == 0) ? _mm_unpacklo_epi16(dx, dx) : _mm_unpackhi_epi16(dx, dx);
+        __m128i dy32 = (half == 0) ? _mm_unpacklo_epi16(dy, dy) : _mm_unpackhi_epi16(dy, dy);
+        __m128 nx = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(dx32, 16)), negScale);
+        __m128 ny = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(dy32, 16)), negScale);
+        __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), one)));
+
+        // Pack to RGBA with the height in alpha
+        __m128i h = (half == 0) ? _mm_unpacklo_epi16(center, zero) : _mm_unpackhi_epi16(center, zero);
+        __m128i rgba = _mm_or_si128(_mm_or_si128(encode(nx, invLength), _mm_slli_epi32(encode(ny, invLength), 8)),
+                                    _mm_or_si128(_mm_slli_epi32(encode(one, invLength), 16), _mm_slli_epi32(h, 24)));
+        _mm_storeu_si128((__m128i*)(dest + (x + half * 4) * 4), rgba);
+      }
+    }
+  }
+#endif // GLM_ARCH_SSE2_BIT
+
+  for (; x < width; x++) {
+    convert_pixel(x);
+  }
+}
+
+void convert_height_to_normal(uint8_t* dest, const uint8_t* heights, int width, int height, float scale, JobSystem* jobSystem) {
+
+  // Sobel slopes are 8 times the height difference per texel
+  float slopeScale = scale / (255.0f * 8.0f);
+  auto convert_row = [&](uint32_t y) {
+    const uint8_t* row = heights + size_t(y) * width;
+    const uint8_t* rowUp = heights + size_t((y > 0) ? y - 1 : height - 1) * width;
+    const uint8_t* rowDown = heights + size_t((int(y) < height - 1) ? y + 1 : 0) * width;
+    convert_height_row(dest + size_t(y) * width * 4, rowUp, row, rowDown, width, slopeScale);
+  };
+
+  if (jobSystem != nullptr) {
+    jobSystem->parallelFor(uint32_t(height), convert_row, 16);
+  }
+  else {
+    for (int y = 0; y < height; y++) {
+      convert_row(uint32_t(y));
+    }
+  }
+}
+
+bool load_image(const char* filename, ImageData& ret_image, bool useMipmaps, MipFilter mipFilter, float normalMapScale, JobSystem* jobSystem) {
+
+  free_image_data(ret_image);
+
+  if (has_extension(filename, ".dds")) {
+    if (!load_dds_image(filename, ret_image)) {
+      free_image_data(ret_image);
+      return false;
+    }
+    return true;
+  }
+
+  int texN = 0;
+  if (normalMapScale != 0.0f) {
+    uint8_t* heights = stbi_load(filename, &ret_image.width, &ret_image.height, &texN, 1);
+    if (heights == nullptr) {
+      return false;
+    }
+    ret_image.pixels = (uint8_t*)STBI_MALLOC(size_t(ret_image.width) * ret_image.height * 4);
+    if (ret_image.pixels != nullptr) {
+      convert_height_to_normal(ret_image.pixels, heights, ret_image.width, ret_image.height, normalMapScale, jobSystem);
+    }
+    stbi_image_free(heights);
+  }
+  else {
+    ret_image.pixels = stbi_load(filename, &ret_image.width, &ret_image.height, &texN, 4);
+  }
+  if (ret_image.pixels == nullptr) {
+    return false;
+  }
+  ret_image.mipCount = 1;
+  ret_image.levels[0] = { .ptr = ret_image.pixels, .size = size_t(ret_image.width) * ret_image.height * 4 };
 
   // Create mip maps if needed
-  local_desc.data.subimage[0][0] = { .ptr = texData, .size = size_t(local_desc.width) * local_desc.height * 4 };
-  if (useMipmaps &&
-    is_power2(local_desc.width) &&
-    is_power2(local_desc.height)) {
+  if (useMipmaps) {
 
-    int mip_count = get_mipmap_count(local_desc.width, local_desc.height);
+    int mip_count = get_mipmap_count(ret_image.width, ret_image.height);
     if (mip_count <= SG_MAX_MIPMAPS) {
-      local_desc.num_mipmaps = mip_count;
+      ret_image.mipCount = mip_count;
 
       // Calcuulate the required total size 
       size_t totalSize = 0;
-      int w = local_desc.width;
-      int h = local_desc.height;
+      int w = ret_image.width;
+      int h = ret_image.height;
       for (int i = 1; i < mip_count; i++) {
         if (w > 1) { w >>= 1; }
         if (h > 1) { h >>= 1; }
         totalSize += size_t(w) * h * 4;
       }
 
-      loadbuffer.resize(totalSize);
-      uint8_t* load_ptr = loadbuffer.data();
+      ret_image.mipData.resize(totalSize);
+      uint8_t* load_ptr = ret_image.mipData.data();
 
       // Build mip-maps
-      w = local_desc.width;
-      h = local_desc.height;
+      w = ret_image.width;
+      h = ret_image.height;
       for (int i = 1; i < mip_count; i++) {
         int old_w = w;
         int old_h = h;
@@ -82,18 +506,60 @@ sg_image create_texture(const char* filename, std::vector<uint8_t>& loadbuffer,
         if (h > 1) { h >>= 1; }
 
         size_t newSize = size_t(w) * h * 4;
-        local_desc.data.subimage[0][i] = { .ptr = load_ptr, .size = newSize };
+        ret_image.levels[i] = { .ptr = load_ptr, .size = newSize };
         load_ptr += newSize;
 
-        build_mipmapRGBA8((uint8_t*)local_desc.data.subimage[0][i].ptr,
-                          (uint8_t*)local_desc.data.subimage[0][i - 1].ptr, old_w, old_h);
+        build_mipmapRGBA8((uint8_t*)ret_image.levels[i].ptr,
+                          (const uint8_t*)ret_image.levels[i - 1].ptr, old_w, old_h, mipFilter);
       }
     }
   }
   // DT_TODO: Fail if cannot create requested mips?
 
-  sg_image tex = sg_make_image(local_desc);
-  stbi_image_free(texData);
+  return true;
+}
+
+sg_image make_image(const ImageData& image) {
+  if (image.mipCount == 0) {
+    return sg_image{};
+  }
+
+  sg_image_desc local_desc = {};
+  local_desc.width = image.width;
+  local_desc.height = image.height;
+  local_desc.num_mipmaps = image.mipCount;
+  local_desc.pixel_format = image.format;
+  for (int i = 0; i < image.mipCount; i++) {
+    local_desc.data.subimage[0][i] = image.levels[i];
+  }
+
+  return sg_make_image(local_desc);
+}
+
+void free_image_data(ImageData& image) {
+  if (image.pixels != nullptr) {
+    stbi_image_free(image.pixels);
+    image.pixels = nullptr;
+  }
+  image.mipData.resize(0);
+  image.file.close();
+  image.mipCount = 0;
+  image.format = SG_PIXELFORMAT_RGBA8;
+}
+
+sg_image create_texture(const char* filename, std::vector<uint8_t>& loadbuffer, bool useMipmaps, MipFilter mipFilter) {
+
+  // Re-use the load buffer for the mips
+  ImageData image;
+  image.mipData.swap(loadbuffer);
+  if (!load_image(filename, image, useMipmaps, mipFilter)) {
+    image.mipData.swap(loadbuffer);
+    return sg_image{};
+  }
+
+  sg_image tex = make_image(image);
+  free_image_data(image);
+  image.mipData.swap(loadbuffer);
 
   return tex;
 }
@@ -1,8 +1,45 @@
 #ifndef _IMAGE_H_
 #define _IMAGE_H_
 #include "external/sokol_gfx.h"
+#include "MappedFile.h"
+#include "JobSystem.h"
 #include <vector>
 
-sg_image create_texture(const char* filename, std::vector<uint8_t>& loadbuffer, bool useMipmaps = true);
+// How mip levels are filtered from the level above (box filter, odd sizes fold the last row/column in)
+enum MipFilter {
+  MIP_FILTER_LINEAR, // Average of the stored values
+  MIP_FILTER_SRGB,   // Colors averaged in linear space (alpha is linear)
+  MIP_FILTER_NORMAL, // Normal map, averaged vector is renormalized (alpha is averaged)
+};
+
+// Image with the mip chain ready to upload
+struct ImageData {
+  int width = 0;
+  int height = 0;
+  int mipCount = 0;
+  sg_pixel_format format = SG_PIXELFORMAT_RGBA8;
+  sg_range levels[SG_MAX_MIPMAPS] = {};
+
+  uint8_t* pixels = nullptr;    // Decoded top level (RGBA8)
+  std::vector<uint8_t> mipData; // Decoded lower levels
+  MappedFile file;              // Block compressed files are uploaded straight from the mapping
+};
+
+// Build the next mip level of an RGBA8 image (the new size is width / 2 x height / 2, minimum 1)
+void build_mipmapRGBA8(uint8_t* dest, const uint8_t* src, int width, int height, MipFilter mipFilter = MIP_FILTER_LINEAR);
+
+// Convert a height map to a RGBA8 normal map (height is kept in alpha). Edges wrap.
+// Rows are split over the job system if one is passed.
+void convert_height_to_normal(uint8_t* dest, const uint8_t* heights, int width, int height, float scale, JobSystem* jobSystem = nullptr);
+
+// Load an image and build the mips on the CPU (thread safe, does not use sokol).
+// .dds files with BC1/BC3/BC5 data are not decoded, the check that the format is supported is left to the caller.
+// If normalMapScale is non-zero the image is treated as a height map and converted to a normal map.
+bool load_image(const char* filename, ImageData& ret_image, bool useMipmaps = true, MipFilter mipFilter = MIP_FILTER_LINEAR,
+                float normalMapScale = 0.0f, JobSystem* jobSystem = nullptr);
+sg_image make_image(const ImageData& image);
+void free_image_data(ImageData& image);
+
+sg_image create_texture(const char* filename, std::vector<uint8_t>& loadbuffer, bool useMipmaps = true, MipFilter mipFilter = MIP_FILTER_LINEAR);
 
 #endif // _IMAGE_H_
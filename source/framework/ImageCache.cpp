@@ -0,0 +1,169 @@
+#include "ImageCache.h"
+#include <string.h>
+#include <stdio.h>
+#include <string>
+#include <filesystem>
+
+// Cache file layout
+//   ImageCacheHeader
+//   Source path (pathLength bytes)
+//   Mip levels (16 byte aligned)
+const uint32_t IMAGE_CACHE_FILE_ID = 0x58455450; // "PTEX"
+const uint32_t IMAGE_CACHE_VERSION = 2;
+
+struct ImageCacheHeader {
+  uint32_t fileId;
+  uint32_t version;
+  uint64_t sourceSize;
+  int64_t sourceTime;
+  uint32_t useMipmaps;
+  uint32_t mipFilter;
+  float normalMapScale;
+  uint32_t pathLength;
+  int32_t width;
+  int32_t height;
+  int32_t mipCount;
+  uint32_t format;
+  uint32_t levelOffsets[SG_MAX_MIPMAPS];
+  uint32_t levelSizes[SG_MAX_MIPMAPS];
+};
+
+static uint64_t hash_fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+static std::string get_cache_file_name(const char* filename, const char* cacheDirectory, const ImageCacheHeader& header) {
+  uint64_t hash = hash_fnv1a(filename, strlen(filename));
+  hash = hash_fnv1a(&header.useMipmaps, sizeof(header.useMipmaps), hash);
+  hash = hash_fnv1a(&header.mipFilter, sizeof(header.mipFilter), hash);
+  hash = hash_fnv1a(&header.normalMapScale, sizeof(header.normalMapScale), hash);
+
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.tex", (unsigned long long)hash);
+  return std::string(cacheDirectory) + "/" + name;
+}
+
+static bool read_cache_file(const char* cacheFile, const ImageCacheHeader& expected, const char* filename, ImageData& ret_image) {
+  if (!ret_image.file.open(cacheFile)) {
+    return false;
+  }
+  const uint8_t* data = ret_image.file.getData();
+  size_t size = ret_image.file.getSize();
+
+  ImageCacheHeader header;
+  if (size < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (header.fileId != IMAGE_CACHE_FILE_ID ||
+      header.version != IMAGE_CACHE_VERSION ||
+      header.sourceSize != expected.sourceSize ||
+      header.sourceTime != expected.sourceTime ||
+      header.useMipmaps != expected.useMipmaps ||
+      header.mipFilter != expected.mipFilter ||
+      header.normalMapScale != expected.normalMapScale ||
+      header.pathLength != expected.pathLength ||
+      sizeof(header) + uint64_t(header.pathLength) > size ||
+      memcmp(data + sizeof(header), filename, header.pathLength) != 0 ||
+      header.mipCount <= 0 || header.mipCount > SG_MAX_MIPMAPS ||
+      header.width <= 0 || header.height <= 0) {
+    return false;
+  }
+
+  for (int i = 0; i < header.mipCount; i++) {
+    if (uint64_t(header.levelOffsets[i]) + header.levelSizes[i] > size) {
+      return false;
+    }
+    ret_image.levels[i] = { .ptr = data + header.levelOffsets[i], .size = header.levelSizes[i] };
+  }
+  ret_image.width = header.width;
+  ret_image.height = header.height;
+  ret_image.mipCount = header.mipCount;
+  ret_image.format = sg_pixel_format(header.format);
+  return true;
+}
+
+static bool write_cache_file(const char* cacheFile, ImageCacheHeader header, const char* filename, const ImageData& image) {
+
+  header.width = image.width;
+  header.height = image.height;
+  header.mipCount = image.mipCount;
+  header.format = uint32_t(image.format);
+
+  uint64_t offset = sizeof(header) + header.pathLength;
+  for (int i = 0; i < image.mipCount; i++) {
+    offset = (offset + 15) & ~uint64_t(15);
+    header.levelOffsets[i] = uint32_t(offset);
+    header.levelSizes[i] = uint32_t(image.levels[i].size);
+    offset += image.levels[i].size;
+  }
+  if (offset > UINT32_MAX) {
+    return false;
+  }
+
+  // Written to a temporary file first so a partial file is never picked up
+  std::string tempFile = std::string(cacheFile) + ".tmp";
+  FILE* file = fopen(tempFile.c_str(), "wb");
+  if (file == NULL) {
+    return false;
+  }
+
+  const uint8_t padding[16] = {};
+  bool success = (fwrite(&header, sizeof(header), 1, file) == 1);
+  success &= (fwrite(filename, 1, header.pathLength, file) == header.pathLength);
+  uint64_t pos = sizeof(header) + header.pathLength;
+  for (int i = 0; i < image.mipCount && success; i++) {
+    success &= (fwrite(padding, 1, size_t(header.levelOffsets[i] - pos), file) == header.levelOffsets[i] - pos);
+    success &= (fwrite(image.levels[i].ptr, 1, image.levels[i].size, file) == image.levels[i].size);
+    pos = header.levelOffsets[i] + image.levels[i].size;
+  }
+  success &= (fclose(file) == 0);
+
+  std::error_code error;
+  if (success) {
+    std::filesystem::rename(tempFile, cacheFile, error);
+    success = !error;
+  }
+  if (!success) {
+    std::filesystem::remove(tempFile, error);
+  }
+  return success;
+}
+
+bool load_image_cached(const char* filename, const char* cacheDirectory, ImageData& ret_image, bool useMipmaps, MipFilter mipFilter,
+                       float normalMapScale, JobSystem* jobSystem) {
+
+  ImageCacheHeader header = {};
+  header.fileId = IMAGE_CACHE_FILE_ID;
+  header.version = IMAGE_CACHE_VERSION;
+  header.useMipmaps = useMipmaps ? 1 : 0;
+  header.mipFilter = uint32_t(mipFilter);
+  header.normalMapScale = normalMapScale;
+  header.pathLength = uint32_t(strlen(filename));
+  if (!get_file_info(filename, header.sourceSize, header.sourceTime)) {
+    return load_image(filename, ret_image, useMipmaps, mipFilter, normalMapScale, jobSystem);
+  }
+
+  free_image_data(ret_image);
+  std::string cacheFile = get_cache_file_name(filename, cacheDirectory, header);
+  if (read_cache_file(cacheFile.c_str(), header, filename, ret_image)) {
+    return true;
+  }
+
+  // Load from the source and store it for next time (a failed write only loses the caching)
+  if (!load_image(filename, ret_image, useMipmaps, mipFilter, normalMapScale, jobSystem)) {
+    return false;
+  }
+
+  // Files that are already mapped (block compressed) are not worth caching
+  if (!ret_image.file.isOpen()) {
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+    write_cache_file(cacheFile.c_str(), header, filename, ret_image);
+  }
+  return true;
+}
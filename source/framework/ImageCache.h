@@ -0,0 +1,12 @@
+#ifndef _IMAGE_CACHE_H_
+#define _IMAGE_CACHE_H_
+
+#include "Image.h"
+
+// On-disk cache of ready to upload images (all mip levels).
+// Entries are keyed by the source path and load options, and are rebuilt when the size or modification time of the
+// source changes. Cached images are mapped from the cache file (thread safe, does not use sokol).
+bool load_image_cached(const char* filename, const char* cacheDirectory, ImageData& ret_image, bool useMipmaps = true, MipFilter mipFilter = MIP_FILTER_LINEAR,
+                       float normalMapScale = 0.0f, JobSystem* jobSystem = nullptr);
+
+#endif // _IMAGE_CACHE_H_
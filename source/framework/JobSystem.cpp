@@ -0,0 +1,133 @@
+#include "JobSystem.h"
+
+JobSystem::~JobSystem() {
+  shutdown();
+}
+
+void JobSystem::init(uint32_t threadCount) {
+  shutdown();
+
+  if (threadCount == 0) {
+    uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    threadCount = (hardwareThreads > 1) ? hardwareThreads - 1 : 0;
+  }
+
+  exiting = false;
+  for (uint32_t i = 0; i < threadCount; i++) {
+    threads.emplace_back(&JobSystem::workerLoop, this);
+  }
+}
+
+void JobSystem::shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    exiting = true;
+  }
+  jobSignal.notify_all();
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+
+  // Run anything left over so queued work is never lost
+  while (runPendingJob()) {}
+}
+
+void JobSystem::addJob(Job job) {
+  if (threads.empty()) {
+    job();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    jobs.push_back(std::move(job));
+  }
+  jobSignal.notify_one();
+}
+
+// Must hold jobMutex
+bool JobSystem::popJob(Job& ret_job) {
+  std::deque<Job>& queue = !frameJobs.empty() ? frameJobs : jobs;
+  if (queue.empty()) {
+    return false;
+  }
+  ret_job = std::move(queue.front());
+  queue.pop_front();
+  return true;
+}
+
+bool JobSystem::runPendingJob() {
+  Job job;
+  {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    if (!popJob(job)) {
+      return false;
+    }
+  }
+  job();
+  return true;
+}
+
+void JobSystem::workerLoop() {
+  for (;;) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(jobMutex);
+      jobSignal.wait(lock, [this]() { return exiting || !frameJobs.empty() || !jobs.empty(); });
+      if (!popJob(job)) {
+        return;
+      }
+    }
+    job();
+  }
+}
+
+void JobSystem::runBatches(ParallelForState& state) {
+  for (;;) {
+    uint32_t start = state.nextIndex.fetch_add(state.batchSize);
+    if (start >= state.count) {
+      return;
+    }
+    uint32_t end = (state.count - start > state.batchSize) ? start + state.batchSize : state.count;
+    for (uint32_t i = start; i < end; i++) {
+      (*state.func)(i);
+    }
+    state.doneCount.fetch_add(end - start);
+  }
+}
+
+void JobSystem::parallelFor(uint32_t count, const std::function<void(uint32_t)>& func, uint32_t batchSize) {
+  if (count == 0) {
+    return;
+  }
+  if (batchSize == 0) {
+    batchSize = 1;
+  }
+
+  // Indices are claimed in batches by the workers and the calling thread.
+  // Helpers that start once all indices are claimed return without touching func, so only the batches are waited on.
+  std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+  state->func = &func;
+  state->count = count;
+  state->batchSize = batchSize;
+
+  uint32_t batchCount = (count + batchSize - 1) / batchSize;
+  uint32_t helperCount = (batchCount - 1 < getThreadCount()) ? batchCount - 1 : getThreadCount();
+  if (helperCount > 0) {
+    {
+      std::lock_guard<std::mutex> lock(jobMutex);
+      for (uint32_t i = 0; i < helperCount; i++) {
+        frameJobs.push_back([state]() { runBatches(*state); });
+      }
+    }
+    jobSignal.notify_all();
+  }
+  runBatches(*state);
+
+  // Wait for the batches claimed by the workers, without picking up unrelated (possibly long) jobs
+  while (state->doneCount.load() < count) {
+    std::this_thread::yield();
+  }
+}
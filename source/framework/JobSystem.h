@@ -0,0 +1,67 @@
+#ifndef _JOB_SYSTEM_H_
+#define _JOB_SYSTEM_H_
+
+#include <cstdint>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+// Pool of worker threads running queued jobs.
+// Jobs of parallelFor go in a separate queue that workers empty before taking background jobs (addJob), so waited on
+// work (eg. per frame updates) is not stuck behind long background jobs (eg. texture loads). A thread waiting in
+// parallelFor only runs batches of its own loop, so jobs may also call parallelFor.
+class JobSystem
+{
+public:
+
+  typedef std::function<void()> Job;
+
+  JobSystem() = default;
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  // Start the workers (0 = one per hardware thread, excluding the calling thread)
+  void init(uint32_t threadCount = 0);
+  void shutdown();
+
+  inline uint32_t getThreadCount() const { return uint32_t(threads.size()); }
+
+  // Queue a background job to run on a worker thread (runs on the calling thread if there are no workers)
+  void addJob(Job job);
+
+  // Run func(index) for index in [0, count) across the workers and the calling thread, returns when all are done
+  void parallelFor(uint32_t count, const std::function<void(uint32_t)>& func, uint32_t batchSize = 1);
+
+protected:
+
+  // Index range of a parallelFor, shared with its helper jobs as they can start after the loop has returned
+  struct ParallelForState {
+    const std::function<void(uint32_t)>* func;
+    uint32_t count;
+    uint32_t batchSize;
+    std::atomic<uint32_t> nextIndex = 0;
+    std::atomic<uint32_t> doneCount = 0;
+  };
+
+  static void runBatches(ParallelForState& state);
+
+  void workerLoop();
+  bool popJob(Job& ret_job);
+  bool runPendingJob();
+
+  std::vector<std::thread> threads;
+  std::deque<Job> frameJobs; // parallelFor helpers, run first
+  std::deque<Job> jobs;
+  std::mutex jobMutex;
+  std::condition_variable jobSignal;
+  bool exiting = false;
+};
+
+#endif // _JOB_SYSTEM_H_
@@ -0,0 +1,136 @@
+#include "Level.h"
+#include <stdio.h>
+#include <string.h>
+
+uint32_t LevelBuilder::addSector(const char* modelName, const vec3& offset) {
+  SectorData data = {};
+  data.sector.modelName = (uint32_t)stringData.size();
+  data.sector.offset[0] = offset.x;
+  data.sector.offset[1] = offset.y;
+  data.sector.offset[2] = offset.z;
+  stringData.insert(stringData.end(), modelName, modelName + strlen(modelName) + 1);
+
+  sectors.push_back(data);
+  return (uint32_t)sectors.size() - 1;
+}
+
+void LevelBuilder::addPortal(uint32_t fromSector, uint32_t toSector, const vec3& c0, const vec3& c1, const vec3& c2) {
+  LevelPortal portal = {};
+  portal.sector = toSector;
+  const vec3* corners[3] = { &c0, &c1, &c2 };
+  for (uint32_t i = 0; i < 3; i++) {
+    portal.corners[i][0] = corners[i]->x;
+    portal.corners[i][1] = corners[i]->y;
+    portal.corners[i][2] = corners[i]->z;
+  }
+  sectors[fromSector].portals.push_back(portal);
+}
+
+void LevelBuilder::addLight(uint32_t sector, const LevelLight& light) {
+  sectors[sector].lights.push_back(light);
+}
+
+bool parse_level(const uint8_t* data, size_t size, LevelData& ret_level) {
+  ret_level = LevelData{};
+  if (size < sizeof(LevelHeader)) {
+    return false;
+  }
+
+  const LevelHeader* header = (const LevelHeader*)data;
+  if (header->fileId != LEVEL_FILE_ID ||
+      header->version != LEVEL_FILE_VERSION) {
+    return false;
+  }
+
+  // Check the sizes (in 64 bit to avoid overflow)
+  uint64_t sectorsOffset = sizeof(LevelHeader);
+  uint64_t portalsOffset = sectorsOffset + uint64_t(header->sectorCount) * sizeof(LevelSector);
+  uint64_t lightsOffset  = portalsOffset + uint64_t(header->portalCount) * sizeof(LevelPortal);
+  uint64_t stringOffset  = lightsOffset  + uint64_t(header->lightCount)  * sizeof(LevelLight);
+  uint64_t totalSize     = stringOffset  + header->stringDataSize;
+  if (totalSize > size) {
+    return false;
+  }
+
+  const LevelSector* sectors = (const LevelSector*)(data + sectorsOffset);
+  const LevelPortal* portals = (const LevelPortal*)(data + portalsOffset);
+  const char* stringData = (const char*)(data + stringOffset);
+
+  // Strings must be terminated
+  if (header->stringDataSize > 0 &&
+      stringData[header->stringDataSize - 1] != '\0') {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < header->sectorCount; i++) {
+    const LevelSector& sector = sectors[i];
+    if (sector.modelName >= header->stringDataSize ||
+        uint64_t(sector.portalStart) + sector.portalCount > header->portalCount ||
+        uint64_t(sector.lightStart) + sector.lightCount > header->lightCount) {
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i < header->portalCount; i++) {
+    if (portals[i].sector >= header->sectorCount) {
+      return false;
+    }
+  }
+
+  ret_level.header = header;
+  ret_level.sectors = sectors;
+  ret_level.portals = portals;
+  ret_level.lights = (const LevelLight*)(data + lightsOffset);
+  ret_level.stringData = stringData;
+  return true;
+}
+
+bool load_level_from_file(const char* fileName, MappedFile& ret_file, LevelData& ret_level) {
+  if (!ret_file.open(fileName)) {
+    return false;
+  }
+  if (!parse_level(ret_file.getData(), ret_file.getSize(), ret_level)) {
+    ret_file.close();
+    return false;
+  }
+  return true;
+}
+
+bool save_level_to_file(const char* fileName, const LevelBuilder& builder) {
+
+  LevelHeader header = {};
+  header.fileId = LEVEL_FILE_ID;
+  header.version = LEVEL_FILE_VERSION;
+  header.sectorCount = (uint32_t)builder.sectors.size();
+  header.stringDataSize = (uint32_t)builder.stringData.size();
+
+  // Flatten the portals and lights into arrays ordered by sector
+  std::vector<LevelSector> sectors;
+  std::vector<LevelPortal> portals;
+  std::vector<LevelLight> lights;
+  for (const LevelBuilder::SectorData& data : builder.sectors) {
+    LevelSector sector = data.sector;
+    sector.portalStart = (uint32_t)portals.size();
+    sector.portalCount = (uint32_t)data.portals.size();
+    sector.lightStart = (uint32_t)lights.size();
+    sector.lightCount = (uint32_t)data.lights.size();
+    sectors.push_back(sector);
+
+    portals.insert(portals.end(), data.portals.begin(), data.portals.end());
+    lights.insert(lights.end(), data.lights.begin(), data.lights.end());
+  }
+  header.portalCount = (uint32_t)portals.size();
+  header.lightCount = (uint32_t)lights.size();
+
+  FILE* file = fopen(fileName, "wb");
+  if (file == NULL) return false;
+
+  bool success = (fwrite(&header, sizeof(header), 1, file) == 1);
+  success &= (fwrite(sectors.data(), sizeof(LevelSector), sectors.size(), file) == sectors.size());
+  success &= (fwrite(portals.data(), sizeof(LevelPortal), portals.size(), file) == portals.size());
+  success &= (fwrite(lights.data(), sizeof(LevelLight), lights.size(), file) == lights.size());
+  success &= (fwrite(builder.stringData.data(), 1, builder.stringData.size(), file) == builder.stringData.size());
+  fclose(file);
+
+  return success;
+}
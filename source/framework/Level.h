@@ -0,0 +1,92 @@
+#ifndef _LEVEL_H_
+#define _LEVEL_H_
+
+#include "Vector.h"
+#include "MappedFile.h"
+#include <vector>
+
+// Binary level file. All sections are arrays of 4 byte aligned plain structs, so a file loaded or
+// memory mapped into memory can be used in place (values are little endian).
+//   LevelHeader
+//   LevelSector[sectorCount]
+//   LevelPortal[portalCount]   - Ordered by sector (see LevelSector::portalStart)
+//   LevelLight[lightCount]     - Ordered by sector (see LevelSector::lightStart)
+//   char[stringDataSize]       - Null terminated strings, referenced by byte offset
+
+const uint32_t LEVEL_FILE_ID = 0x4C564C50; // "PLVL"
+const uint32_t LEVEL_FILE_VERSION = 1;
+
+struct LevelHeader {
+  uint32_t fileId;
+  uint32_t version;
+  uint32_t sectorCount;
+  uint32_t portalCount;
+  uint32_t lightCount;
+  uint32_t stringDataSize;
+};
+
+struct LevelSector {
+  uint32_t modelName; // String offset
+  float offset[3];
+  uint32_t portalStart;
+  uint32_t portalCount;
+  uint32_t lightStart;
+  uint32_t lightCount;
+};
+
+struct LevelPortal {
+  uint32_t sector;     // Sector the portal leads to
+  float corners[3][3]; // Corner, corner along the first edge, corner along the second edge (see Portal)
+};
+
+struct LevelParticles {
+  float spawnRate;
+  float speed, speedSpread;
+  float life, lifeSpread;
+  float size, sizeSpread;
+  float directionalForce[3];
+  float frictionFactor;
+  float colors[12][4];
+};
+
+struct LevelLight {
+  float position[3];
+  float radius;
+  float offsetScale[3]; // Scale of the animated light offset
+  LevelParticles particles;
+};
+
+// View of a level in memory (points into the file data)
+struct LevelData {
+  const LevelHeader* header = nullptr;
+  const LevelSector* sectors = nullptr;
+  const LevelPortal* portals = nullptr;
+  const LevelLight* lights = nullptr;
+  const char* stringData = nullptr;
+
+  inline const char* getString(uint32_t offset) const { return stringData + offset; }
+};
+
+// Used to create level files
+struct LevelBuilder {
+  uint32_t addSector(const char* modelName, const vec3& offset);
+  void addPortal(uint32_t fromSector, uint32_t toSector, const vec3& c0, const vec3& c1, const vec3& c2);
+  void addLight(uint32_t sector, const LevelLight& light);
+
+  struct SectorData {
+    LevelSector sector;
+    std::vector<LevelPortal> portals;
+    std::vector<LevelLight> lights;
+  };
+  std::vector<SectorData> sectors;
+  std::vector<char> stringData;
+};
+
+// Validate level data in memory and setup a view of it (data must stay valid while the view is used)
+bool parse_level(const uint8_t* data, size_t size, LevelData& ret_level);
+
+// Map a level file and setup a view of it (the file must stay open while the view is used)
+bool load_level_from_file(const char* fileName, MappedFile& ret_file, LevelData& ret_level);
+bool save_level_to_file(const char* fileName, const LevelBuilder& builder);
+
+#endif // _LEVEL_H_
@@ -0,0 +1,135 @@
+#include "MappedFile.h"
+#include <utility>
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+  *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+#ifdef _WIN32
+    std::swap(fileHandle, other.fileHandle);
+    std::swap(mappingHandle, other.mappingHandle);
+#endif
+  }
+  return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char* fileName, bool copyOnWrite) {
+  close();
+
+  HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER fileSize = {};
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, NULL, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+  if (mapping == NULL) {
+    CloseHandle(file);
+    return false;
+  }
+
+  void* view = MapViewOfFile(mapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+  if (view == NULL) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  fileHandle = file;
+  mappingHandle = mapping;
+  data = (uint8_t*)view;
+  size = (size_t)fileSize.QuadPart;
+  return true;
+}
+
+void MappedFile::close() {
+  if (data != nullptr) {
+    UnmapViewOfFile(data);
+  }
+  if (mappingHandle != nullptr) {
+    CloseHandle((HANDLE)mappingHandle);
+  }
+  if (fileHandle != nullptr) {
+    CloseHandle((HANDLE)fileHandle);
+  }
+  data = nullptr;
+  size = 0;
+  mappingHandle = nullptr;
+  fileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const char* fileName, bool copyOnWrite) {
+  close();
+
+  int file = ::open(fileName, O_RDONLY);
+  if (file < 0) {
+    return false;
+  }
+
+  struct stat fileStat = {};
+  if (fstat(file, &fileStat) != 0 || fileStat.st_size <= 0) {
+    ::close(file);
+    return false;
+  }
+
+  int protection = copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  void* view = mmap(nullptr, (size_t)fileStat.st_size, protection, MAP_PRIVATE, file, 0);
+  ::close(file); // The mapping keeps a reference to the file
+  if (view == MAP_FAILED) {
+    return false;
+  }
+
+  data = (uint8_t*)view;
+  size = (size_t)fileStat.st_size;
+  return true;
+}
+
+void MappedFile::close() {
+  if (data != nullptr) {
+    munmap(data, size);
+  }
+  data = nullptr;
+  size = 0;
+}
+
+#endif
+
+bool get_file_info(const char* fileName, uint64_t& ret_size, int64_t& ret_time) {
+  std::error_code error;
+  ret_size = std::filesystem::file_size(fileName, error);
+  if (error) {
+    return false;
+  }
+  ret_time = int64_t(std::filesystem::last_write_time(fileName, error).time_since_epoch().count());
+  return !error;
+}
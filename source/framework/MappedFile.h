@@ -0,0 +1,43 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <cstdint>
+#include <cstddef>
+
+// Memory mapping of a whole file.
+// Copy-on-write mappings can be modified in memory (only the touched pages are copied, the file is never changed).
+class MappedFile
+{
+public:
+
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  bool open(const char* fileName, bool copyOnWrite = false);
+  void close();
+
+  inline bool isOpen() const { return data != nullptr; }
+  inline uint8_t* getData() const { return data; }
+  inline size_t getSize() const { return size; }
+
+protected:
+
+  uint8_t* data = nullptr;
+  size_t size = 0;
+
+#ifdef _WIN32
+  void* fileHandle = nullptr;
+  void* mappingHandle = nullptr;
+#endif
+};
+
+// Size and last write time of a file, used to check generated files (eg. caches) are up to date with their source
+bool get_file_info(const char* fileName, uint64_t& ret_size, int64_t& ret_time);
+
+#endif // _MAPPED_FILE_H_
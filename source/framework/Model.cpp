@@ -1,4 +1,5 @@
 #include "Model.h"
+#include <string.h>
 
 float getValue(const uint8_t* src, const unsigned int index, const AttributeFormat attFormat) {
   switch (attFormat) {
@@ -30,26 +31,72 @@ bool findAttribute(const Batch& batch, const AttributeType attType, const unsign
   return false;
 }
 
-bool transform_batch(Batch& batch, const mat4& mat, const AttributeType attType, const unsigned int index) {
-  AttributeFormat format;
-  unsigned int i, j, offset, size;
-  if (!findAttribute(batch, attType, index, &offset)) return false;
-  size = batch.formats[offset].size;
-  format = batch.formats[offset].attFormat;
-  offset = batch.formats[offset].offset;
-
-  for (i = 0; i < batch.nVertices; i++) {
-    uint8_t* src = batch.vertices.data() + i * batch.vertexSize + offset;
+// Transform kernels specialized on the attribute format and component count
+template <AttributeFormat Format, uint32_t Size>
+static void transform_vertices(uint8_t* data, uint32_t count, uint32_t stride, const mat4& mat) {
+  for (uint32_t i = 0; i < count; i++) {
+    uint8_t* src = data + size_t(i) * stride;
 
-    vec4 vec(0, 0, 0, 1);
-    for (j = 0; j < size; j++) {
-      vec.operator [](j) = getValue(src, j, format);
+    float value[4] = { 0, 0, 0, 1 };
+    for (uint32_t j = 0; j < Size; j++) {
+      value[j] = getValue(src, j, Format);
     }
-    vec = mat * vec;
-    for (j = 0; j < size; j++) {
-      setValue(src, j, format, vec.operator [](j));
+    vec4 vec = mat * glm::make_vec4(value);
+    for (uint32_t j = 0; j < Size; j++) {
+      setValue(src, j, Format, vec[j]);
     }
   }
+}
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+// Load/store float3 without touching the following 4 bytes (may be past the end of the buffer)
+static inline __m128 load_float3(const float* src) {
+  __m128 xy = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)src);
+  return _mm_movelh_ps(xy, _mm_load_ss(src + 2));
+}
+
+static inline void store_float3(float* dest, __m128 value) {
+  _mm_storel_pi((__m64*)dest, value);
+  _mm_store_ss(dest + 2, _mm_movehl_ps(value, value));
+}
+
+template <>
+void transform_vertices<ATT_FLOAT, 3>(uint8_t* data, uint32_t count, uint32_t stride, const mat4& mat) {
+  const __m128 col0 = _mm_loadu_ps(&mat[0].x);
+  const __m128 col1 = _mm_loadu_ps(&mat[1].x);
+  const __m128 col2 = _mm_loadu_ps(&mat[2].x);
+  const __m128 col3 = _mm_loadu_ps(&mat[3].x);
+
+  for (uint32_t i = 0; i < count; i++) {
+    float* src = (float*)(data + size_t(i) * stride);
+
+    __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(src[0])), _mm_mul_ps(col1, _mm_set1_ps(src[1]))),
+                               _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(src[2])), col3));
+    store_float3(src, result);
+  }
+}
+
+#endif // GLM_ARCH_SSE2_BIT
+
+bool transform_batch(Batch& batch, const mat4& mat, const AttributeType attType, const unsigned int index) {
+  unsigned int where = 0;
+  if (!findAttribute(batch, attType, index, &where)) return false;
+  const Format& format = batch.formats[where];
+  uint8_t* data = batch.vertexData + format.offset;
+
+  switch (format.attFormat * 8 + format.size) {
+  case ATT_FLOAT * 8 + 1:         transform_vertices<ATT_FLOAT, 1>(data, batch.nVertices, batch.vertexSize, mat); break;
+  case ATT_FLOAT * 8 + 2:         transform_vertices<ATT_FLOAT, 2>(data, batch.nVertices, batch.vertexSize, mat); break;
+  case ATT_FLOAT * 8 + 3:         transform_vertices<ATT_FLOAT, 3>(data, batch.nVertices, batch.vertexSize, mat); break;
+  case ATT_FLOAT * 8 + 4:         transform_vertices<ATT_FLOAT, 4>(data, batch.nVertices, batch.vertexSize, mat); break;
+  case ATT_UNSIGNED_BYTE * 8 + 1: transform_vertices<ATT_UNSIGNED_BYTE, 1>(data, batch.nVertices, batch.vertexSize, mat); break;
+  case ATT_UNSIGNED_BYTE * 8 + 2: transform_vertices<ATT_UNSIGNED_BYTE, 2>(data, batch.nVertices, batch.vertexSize, mat); break;
+  case ATT_UNSIGNED_BYTE * 8 + 3: transform_vertices<ATT_UNSIGNED_BYTE, 3>(data, batch.nVertices, batch.vertexSize, mat); break;
+  case ATT_UNSIGNED_BYTE * 8 + 4: transform_vertices<ATT_UNSIGNED_BYTE, 4>(data, batch.nVertices, batch.vertexSize, mat); break;
+  default:
+    return false;
+  }
 
   return true;
 }
@@ -63,26 +110,72 @@ bool transform_model(Model& ret_model, const mat4& mat) {
   return true;
 }
 
+// Bounding box kernels specialized on the attribute format (positions are always 3 components)
+template <AttributeFormat Format>
+static void bound_vertices(const uint8_t* data, uint32_t count, uint32_t stride, vec3& min, vec3& max) {
+  for (uint32_t i = 0; i < count; i++) {
+    const uint8_t* src = data + size_t(i) * stride;
+
+    for (uint32_t j = 0; j < 3; j++) {
+      float val = getValue(src, j, Format);
+      if (val > max[j]) max[j] = val;
+      if (val < min[j]) min[j] = val;
+    }
+  }
+}
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+template <>
+void bound_vertices<ATT_FLOAT>(const uint8_t* data, uint32_t count, uint32_t stride, vec3& min, vec3& max) {
+  __m128 minValue = _mm_setr_ps(min.x, min.y, min.z, 0.0f);
+  __m128 maxValue = _mm_setr_ps(max.x, max.y, max.z, 0.0f);
+
+  // Two accumulators to break up the dependency chain
+  __m128 minValue2 = minValue;
+  __m128 maxValue2 = maxValue;
+  uint32_t i = 0;
+  for (; i + 1 < count; i += 2) {
+    __m128 value  = load_float3((const float*)(data + size_t(i) * stride));
+    __m128 value2 = load_float3((const float*)(data + size_t(i + 1) * stride));
+    minValue  = _mm_min_ps(value, minValue);
+    maxValue  = _mm_max_ps(value, maxValue);
+    minValue2 = _mm_min_ps(value2, minValue2);
+    maxValue2 = _mm_max_ps(value2, maxValue2);
+  }
+  if (i < count) {
+    __m128 value = load_float3((const float*)(data + size_t(i) * stride));
+    minValue = _mm_min_ps(value, minValue);
+    maxValue = _mm_max_ps(value, maxValue);
+  }
+  minValue = _mm_min_ps(minValue, minValue2);
+  maxValue = _mm_max_ps(maxValue, maxValue2);
+
+  vec4 result;
+  _mm_storeu_ps(&result.x, minValue);
+  min = vec3(result);
+  _mm_storeu_ps(&result.x, maxValue);
+  max = vec3(result);
+}
+
+#endif // GLM_ARCH_SSE2_BIT
+
 bool get_bounding_box(const Batch& batch, vec3& min, vec3& max) {
 
   unsigned int attribIndex = 0;
   if (!findAttribute(batch, ATT_VERTEX, 0, &attribIndex)) return false;
-  uint32_t size          = batch.formats[attribIndex].size;
-  AttributeFormat format = batch.formats[attribIndex].attFormat;
-  uint32_t offset        = batch.formats[attribIndex].offset;
+  const Format& format = batch.formats[attribIndex];
+  const uint8_t* data = batch.vertexData + format.offset;
 
-  if (size != 3) {
+  if (format.size != 3) {
     return false;
   }
 
-  for (uint32_t i = 0; i < batch.nVertices; i++) {
-    const uint8_t* src = batch.vertices.data() + i * batch.vertexSize + offset;
-
-    for (uint32_t j = 0; j < size; j++) {
-      float val = getValue(src, j, format);
-      if (val > max[j]) max[j] = val;
-      if (val < min[j]) min[j] = val;
-    }
+  switch (format.attFormat) {
+  case ATT_FLOAT:         bound_vertices<ATT_FLOAT>(data, batch.nVertices, batch.vertexSize, min, max); break;
+  case ATT_UNSIGNED_BYTE: bound_vertices<ATT_UNSIGNED_BYTE>(data, batch.nVertices, batch.vertexSize, min, max); break;
+  default:
+    return false;
   }
 
   return true;
@@ -101,41 +194,16 @@ bool get_bounding_box(const Model& model, vec3& min, vec3& max) {
   return true;
 }
 
-void read_batch_from_file(FILE* file, Batch& batch) {
-  fread(&batch.nVertices, sizeof(batch.nVertices), 1, file);
-  fread(&batch.nIndices, sizeof(batch.nIndices), 1, file);
-  fread(&batch.vertexSize, sizeof(batch.vertexSize), 1, file);
-  fread(&batch.indexSize, sizeof(batch.indexSize), 1, file);
-
-  fread(&batch.primitiveType, sizeof(batch.primitiveType), 1, file);
-
-  unsigned int nFormats;
-  fread(&nFormats, sizeof(nFormats), 1, file);
-  batch.formats.resize(nFormats);
-  fread(batch.formats.data(), nFormats * sizeof(Format), 1, file);
-
-  batch.vertices.resize(batch.nVertices * batch.vertexSize);
-  fread(batch.vertices.data(), batch.vertices.size(), 1, file);
-
-  if (batch.nIndices > 0) {
-    batch.indices.resize(batch.nIndices * batch.indexSize);
-    fread(batch.indices.data(), batch.indices.size(), 1, file);
-  }
-  else {
-    batch.indices.resize(0);
-  }
-}
-
 bool make_model_renderable(Model& ret_model) {
 
   for (Batch& batch : ret_model.batches) {
-    sg_range index_range = sg_range{ .ptr = batch.indices.data(), .size = batch.indices.size() };
+    sg_range index_range = sg_range{ .ptr = batch.indexData, .size = size_t(batch.nIndices) * batch.indexSize };
     batch.render_index = sg_make_buffer(sg_buffer_desc{
         .type = SG_BUFFERTYPE_INDEXBUFFER,
         .data = index_range,
       });
 
-    sg_range vertex_range = sg_range{ .ptr = batch.vertices.data(), .size = batch.vertices.size() };
+    sg_range vertex_range = sg_range{ .ptr = batch.vertexData, .size = size_t(batch.nVertices) * batch.vertexSize };
     batch.render_vertex = sg_make_buffer(sg_buffer_desc{
         .data = vertex_range,
       });
@@ -147,21 +215,528 @@ bool make_model_renderable(Model& ret_model) {
   return true;
 }
 
+// Copy the indices of a batch, offset to the start of the batch in the packed vertex buffer
+template<typename T>
+static void rebase_indices(const Batch& batch, uint32_t baseVertex, T* dest) {
+  if (batch.indexSize == sizeof(uint16_t)) {
+    const uint16_t* src = (const uint16_t*)batch.indexData;
+    for (uint32_t i = 0; i < batch.nIndices; i++) {
+      dest[i] = T(baseVertex + src[i]);
+    }
+  }
+  else {
+    const uint32_t* src = (const uint32_t*)batch.indexData;
+    for (uint32_t i = 0; i < batch.nIndices; i++) {
+      dest[i] = T(baseVertex + src[i]);
+    }
+  }
+}
+
+bool make_models_renderable_packed(Model* const* models, uint32_t modelCount, uint32_t& ret_indexSize) {
+
+  uint32_t vertexSize = 0;
+  uint64_t totalVertices = 0;
+  uint64_t totalIndices = 0;
+  for (uint32_t m = 0; m < modelCount; m++) {
+    for (const Batch& batch : models[m]->batches) {
+      if (vertexSize == 0) {
+        vertexSize = batch.vertexSize;
+      }
+      if (batch.vertexSize != vertexSize ||
+          batch.nIndices == 0) {
+        return false;
+      }
+      totalVertices += batch.nVertices;
+      totalIndices += batch.nIndices;
+    }
+  }
+  if (totalVertices == 0 || totalVertices > UINT32_MAX || totalIndices > UINT32_MAX) {
+    return false;
+  }
+
+  uint32_t indexSize = (totalVertices <= 0x10000) ? sizeof(uint16_t) : sizeof(uint32_t);
+  std::vector<uint8_t> vertices(size_t(totalVertices) * vertexSize);
+  std::vector<uint8_t> indices(size_t(totalIndices) * indexSize);
+  std::vector<uint32_t> baseElements; // Only set on the batches once the buffers are created
+  uint32_t baseVertex = 0;
+  uint32_t baseElement = 0;
+  for (uint32_t m = 0; m < modelCount; m++) {
+    for (const Batch& batch : models[m]->batches) {
+      memcpy(vertices.data() + size_t(baseVertex) * vertexSize, batch.vertexData, size_t(batch.nVertices) * vertexSize);
+      if (indexSize == sizeof(uint16_t)) {
+        rebase_indices(batch, baseVertex, (uint16_t*)indices.data() + baseElement);
+      }
+      else {
+        rebase_indices(batch, baseVertex, (uint32_t*)indices.data() + baseElement);
+      }
+
+      baseElements.push_back(baseElement);
+      baseVertex += batch.nVertices;
+      baseElement += batch.nIndices;
+    }
+  }
+
+  sg_buffer render_index = sg_make_buffer(sg_buffer_desc{
+      .type = SG_BUFFERTYPE_INDEXBUFFER,
+      .data = sg_range{ .ptr = indices.data(), .size = indices.size() },
+    });
+  sg_buffer render_vertex = sg_make_buffer(sg_buffer_desc{
+      .data = sg_range{ .ptr = vertices.data(), .size = vertices.size() },
+    });
+  if (render_index.id == SG_INVALID_ID ||
+    render_vertex.id == SG_INVALID_ID) {
+    sg_destroy_buffer(render_index);
+    sg_destroy_buffer(render_vertex);
+    return false;
+  }
+
+  size_t batchIndex = 0;
+  for (uint32_t m = 0; m < modelCount; m++) {
+    for (Batch& batch : models[m]->batches) {
+      batch.render_index = render_index;
+      batch.render_vertex = render_vertex;
+      batch.baseElement = baseElements[batchIndex++];
+    }
+  }
+  ret_indexSize = indexSize;
+  return true;
+}
+
+// Header of each batch in a version 1 model file
+struct BatchHeaderV1 {
+  uint32_t nVertices;
+  uint32_t nIndices;
+  uint32_t vertexSize;
+  uint32_t indexSize;
+  uint32_t primitiveType;
+  uint32_t nFormats;
+};
+
+// Reads from an open file, failing if reading past the end
+struct FileReader {
+  FILE* file = nullptr;
+  uint64_t remaining = 0;
+
+  template <typename T>
+  inline bool read(T& ret_value) {
+    if (remaining < sizeof(T) || fread(&ret_value, sizeof(T), 1, file) != 1) return false;
+    remaining -= sizeof(T);
+    return true;
+  }
+
+  // Read the next block of data into the storage (only resized once the file is known to be large enough)
+  inline uint8_t* readData(uint64_t blockSize, std::vector<uint8_t>& storage) {
+    if (remaining < blockSize) return nullptr;
+    storage.resize((size_t)blockSize);
+    if (blockSize > 0 && fread(storage.data(), (size_t)blockSize, 1, file) != 1) return nullptr;
+    remaining -= blockSize;
+    return storage.data();
+  }
+};
+
+// Reads from a block of memory, failing if reading past the end
+struct MemoryReader {
+  uint8_t* data = nullptr;
+  size_t size = 0;
+  size_t pos = 0;
+
+  template <typename T>
+  inline bool read(T& ret_value) {
+    if (size - pos < sizeof(T)) return false;
+    memcpy(&ret_value, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  // Get a pointer to the next block of data in memory and skip it (storage is unused)
+  inline uint8_t* readData(uint64_t blockSize, std::vector<uint8_t>& /*storage*/) {
+    if (size - pos < blockSize) return nullptr;
+    uint8_t* ret = data + pos;
+    pos += (size_t)blockSize;
+    return ret;
+  }
+};
+
+bool validate_formats(const Batch& batch) {
+  for (const Format& format : batch.formats) {
+    uint32_t componentSize = (format.attFormat == ATT_FLOAT) ? sizeof(float) : sizeof(uint8_t);
+    if (format.attType > ATT_COLOR ||
+        format.attFormat > ATT_UNSIGNED_BYTE ||
+        format.size == 0 || format.size > 4 ||
+        (format.attFormat == ATT_FLOAT && (format.offset % sizeof(float) != 0 || batch.vertexSize % sizeof(float) != 0)) ||
+        uint64_t(format.offset) + uint64_t(format.size) * componentSize > batch.vertexSize) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool validate_indices(const uint8_t* indexData, uint32_t nIndices, uint32_t nVertices) {
+  T maxIndex = 0;
+  for (uint32_t i = 0; i < nIndices; i++) {
+    T index;
+    memcpy(&index, indexData + i * sizeof(T), sizeof(T)); // Data may not be aligned
+    maxIndex = (index > maxIndex) ? index : maxIndex;
+  }
+  return (nIndices == 0 || maxIndex < nVertices);
+}
+
+template <typename Reader>
+bool read_batch_v1(Reader& reader, Batch& batch) {
+  BatchHeaderV1 header;
+  if (!reader.read(header)) return false;
+
+  // Check the header values before any sizes are calculated from them
+  if (header.primitiveType > PRIM_LINES ||
+      header.nFormats > MAX_BATCH_FORMATS ||
+      header.vertexSize == 0 || header.vertexSize > MAX_VERTEX_SIZE ||
+      header.nVertices > MAX_BATCH_VERTICES ||
+      header.nIndices > MAX_BATCH_INDICES ||
+      (header.nIndices > 0 && header.indexSize != sizeof(uint16_t) && header.indexSize != sizeof(uint32_t))) {
+    return false;
+  }
+
+  batch.nVertices = header.nVertices;
+  batch.nIndices = header.nIndices;
+  batch.vertexSize = header.vertexSize;
+  batch.indexSize = (header.nIndices > 0) ? header.indexSize : 0;
+  batch.primitiveType = (PrimitiveType)header.primitiveType;
+
+  // Sizes are calculated in 64 bit (cannot overflow with the limits above) and checked against the remaining data by the reader
+  std::vector<uint8_t> formatStorage;
+  uint8_t* formatData = reader.readData(uint64_t(header.nFormats) * sizeof(Format), formatStorage);
+  if (formatData == nullptr) return false;
+  batch.formats.resize(header.nFormats);
+  if (header.nFormats > 0) {
+    memcpy(batch.formats.data(), formatData, header.nFormats * sizeof(Format));
+  }
+  if (!validate_formats(batch)) return false;
+
+  batch.vertexData = reader.readData(uint64_t(batch.nVertices) * batch.vertexSize, batch.vertices);
+  batch.indexData = reader.readData(uint64_t(batch.nIndices) * batch.indexSize, batch.indices);
+  if (batch.vertexData == nullptr ||
+      batch.indexData == nullptr) {
+    return false;
+  }
+
+  // Do not allow indices to reference data outside the vertex buffer
+  if (batch.indexSize == sizeof(uint16_t)) {
+    return validate_indices<uint16_t>(batch.indexData, batch.nIndices, batch.nVertices);
+  }
+  return validate_indices<uint32_t>(batch.indexData, batch.nIndices, batch.nVertices);
+}
+
+template <typename Reader>
+bool read_model(Reader& reader, Model& ret_model) {
+  ret_model.batches.resize(0);
+
+  uint32_t version = 0;
+  uint32_t nBatches = 0;
+  if (!reader.read(version) ||
+      !reader.read(nBatches) ||
+      nBatches > MAX_MODEL_BATCHES) {
+    return false;
+  }
+
+  ret_model.batches.resize(nBatches);
+  for (Batch& batch : ret_model.batches) {
+    bool success = false;
+    switch (version) {
+    case MODEL_VERSION_1: success = read_batch_v1(reader, batch); break;
+    default: break;
+    }
+
+    if (!success) {
+      ret_model.batches.resize(0);
+      return false;
+    }
+  }
+  return true;
+}
+
 bool load_model_from_file(const char* fileName, Model& ret_model) {
   FILE* file = fopen(fileName, "rb");
   if (file == NULL) return false;
 
-  uint32_t version;
-  fread(&version, sizeof(version), 1, file);
-  uint32_t nBatches;
-  fread(&nBatches, sizeof(nBatches), 1, file);
+  FileReader reader;
+  reader.file = file;
+  if (fseek(file, 0, SEEK_END) == 0) {
+    long size = ftell(file);
+    reader.remaining = (size > 0) ? uint64_t(size) : 0;
+  }
+  fseek(file, 0, SEEK_SET);
 
-  ret_model.batches.resize(nBatches);
+  bool success = read_model(reader, ret_model);
+  fclose(file);
+
+  return success;
+}
+
+bool load_model_from_memory(uint8_t* data, size_t size, Model& ret_model) {
+  MemoryReader reader;
+  reader.data = data;
+  reader.size = size;
+  return read_model(reader, ret_model);
+}
+
+bool load_model_from_mapped_file(const char* fileName, Model& ret_model) {
+  ret_model.batches.resize(0);
+  if (!ret_model.file.open(fileName, true)) return false;
+
+  if (!load_model_from_memory(ret_model.file.getData(), ret_model.file.getSize(), ret_model)) {
+    ret_model.file.close();
+    return false;
+  }
+  return true;
+}
+
+void free_model_cpu_data(Model& ret_model) {
   for (Batch& batch : ret_model.batches) {
-    read_batch_from_file(file, batch);
+    batch.vertices = std::vector<uint8_t>();
+    batch.indices = std::vector<uint8_t>();
+    batch.vertexData = nullptr;
+    batch.indexData = nullptr;
+  }
+  ret_model.file.close();
+}
+
+std::string get_cooked_model_name(const char* fileName) {
+  std::string name = fileName;
+  size_t extension = name.find_last_of("./\\");
+  if (extension != std::string::npos && name[extension] == '.') {
+    name.resize(extension);
+  }
+  return name + ".cmdl";
+}
+
+void set_cooked_formats(Batch& batch) {
+  batch.vertexSize = COOKED_VERTEX_SIZE;
+  batch.primitiveType = PRIM_TRIANGLES;
+  batch.formats = {
+    Format{ ATT_VERTEX,   ATT_FLOAT, 3, 0,  0 },
+    Format{ ATT_TEXCOORD, ATT_FLOAT, 2, 12, 0 },
+    Format{ ATT_TEXCOORD, ATT_FLOAT, 3, 20, 1 },
+    Format{ ATT_TEXCOORD, ATT_FLOAT, 3, 32, 2 },
+    Format{ ATT_TEXCOORD, ATT_FLOAT, 3, 44, 3 },
+  };
+}
+
+bool cook_batch(const Batch& batch, const vec3& offset, Batch& ret_cooked) {
+
+  // Source attributes in the order of the cooked layout
+  const AttributeType attTypes[5]  = { ATT_VERTEX, ATT_TEXCOORD, ATT_TEXCOORD, ATT_TEXCOORD, ATT_TEXCOORD };
+  const uint32_t attIndices[5]     = { 0, 0, 1, 2, 3 };
+  const uint32_t attSizes[5]       = { 3, 2, 3, 3, 3 };
+  const Format* formats[5];
+  for (uint32_t a = 0; a < 5; a++) {
+    unsigned int where = 0;
+    if (!findAttribute(batch, attTypes[a], attIndices[a], &where) ||
+        batch.formats[where].size < attSizes[a]) {
+      return false;
+    }
+    formats[a] = &batch.formats[where];
+  }
+
+  set_cooked_formats(ret_cooked);
+  ret_cooked.nVertices = batch.nVertices;
+  ret_cooked.vertices.resize(size_t(batch.nVertices) * COOKED_VERTEX_SIZE);
+  float* dest = (float*)ret_cooked.vertices.data();
+  for (uint32_t i = 0; i < batch.nVertices; i++) {
+    const uint8_t* src = batch.vertexData + size_t(i) * batch.vertexSize;
+    for (uint32_t a = 0; a < 5; a++) {
+      for (uint32_t j = 0; j < attSizes[a]; j++) {
+        float value = getValue(src + formats[a]->offset, j, formats[a]->attFormat);
+        if (a == 0) {
+          value += offset[j];
+        }
+        *dest++ = value;
+      }
+    }
+  }
+
+  // Get the source indices as triangles
+  std::vector<uint32_t> indices;
+  uint32_t nSrcIndices = (batch.nIndices > 0) ? batch.nIndices : batch.nVertices;
+  auto get_index = [&](uint32_t i) -> uint32_t {
+    if (batch.nIndices == 0) return i;
+    if (batch.indexSize == sizeof(uint16_t)) return ((const uint16_t*)batch.indexData)[i];
+    return ((const uint32_t*)batch.indexData)[i];
+  };
+  switch (batch.primitiveType) {
+  case PRIM_TRIANGLES:
+    for (uint32_t i = 0; i + 2 < nSrcIndices; i += 3) {
+      indices.insert(indices.end(), { get_index(i), get_index(i + 1), get_index(i + 2) });
+    }
+    break;
+  case PRIM_QUADS:
+    for (uint32_t i = 0; i + 3 < nSrcIndices; i += 4) {
+      indices.insert(indices.end(), { get_index(i), get_index(i + 1), get_index(i + 2) });
+      indices.insert(indices.end(), { get_index(i), get_index(i + 2), get_index(i + 3) });
+    }
+    break;
+  default:
+    return false;
+  }
+
+  ret_cooked.nIndices = (uint32_t)indices.size();
+  ret_cooked.indexSize = (batch.nVertices <= 0x10000) ? sizeof(uint16_t) : sizeof(uint32_t);
+  ret_cooked.indices.resize(indices.size() * ret_cooked.indexSize);
+  for (size_t i = 0; i < indices.size(); i++) {
+    if (ret_cooked.indexSize == sizeof(uint16_t)) {
+      ((uint16_t*)ret_cooked.indices.data())[i] = (uint16_t)indices[i];
+    }
+    else {
+      ((uint32_t*)ret_cooked.indices.data())[i] = indices[i];
+    }
+  }
+
+  ret_cooked.vertexData = ret_cooked.vertices.data();
+  ret_cooked.indexData = ret_cooked.indices.data();
+  return true;
+}
+
+bool cook_model(const Model& model, const vec3& offset, Model& ret_cooked) {
+  ret_cooked.batches.resize(model.batches.size());
+  for (size_t i = 0; i < model.batches.size(); i++) {
+    if (!cook_batch(model.batches[i], offset, ret_cooked.batches[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint32_t align_offset(uint64_t offset) {
+  return uint32_t((offset + 15) & ~uint64_t(15));
+}
+
+bool save_cooked_model(const char* fileName, const char* sourceFileName, const Model& cooked, const vec3& offset) {
+
+  CookedModelHeader header = {};
+  header.fileId = COOKED_MODEL_FILE_ID;
+  header.version = COOKED_MODEL_VERSION;
+  if (!get_file_info(sourceFileName, header.sourceSize, header.sourceTime)) {
+    return false;
+  }
+  header.batchCount = (uint32_t)cooked.batches.size();
+  memcpy(header.offset, value_ptr(offset), sizeof(header.offset));
+
+  vec3 modelMin, modelMax;
+  if (!get_bounding_box(cooked, modelMin, modelMax)) {
+    return false;
   }
+  memcpy(header.boundsMin, value_ptr(modelMin), sizeof(header.boundsMin));
+  memcpy(header.boundsMax, value_ptr(modelMax), sizeof(header.boundsMax));
 
+  std::vector<CookedBatchHeader> batchHeaders(cooked.batches.size());
+  uint64_t fileOffset = sizeof(CookedModelHeader) + batchHeaders.size() * sizeof(CookedBatchHeader);
+  for (size_t i = 0; i < cooked.batches.size(); i++) {
+    const Batch& batch = cooked.batches[i];
+    CookedBatchHeader& batchHeader = batchHeaders[i];
+    batchHeader.nVertices = batch.nVertices;
+    batchHeader.nIndices = batch.nIndices;
+    batchHeader.indexSize = batch.indexSize;
+
+    vec3 batchMin(FLT_MAX);
+    vec3 batchMax(-FLT_MAX);
+    get_bounding_box(batch, batchMin, batchMax);
+    memcpy(batchHeader.boundsMin, value_ptr(batchMin), sizeof(batchHeader.boundsMin));
+    memcpy(batchHeader.boundsMax, value_ptr(batchMax), sizeof(batchHeader.boundsMax));
+
+    batchHeader.vertexOffset = align_offset(fileOffset);
+    fileOffset = batchHeader.vertexOffset + uint64_t(batch.nVertices) * COOKED_VERTEX_SIZE;
+    batchHeader.indexOffset = align_offset(fileOffset);
+    fileOffset = batchHeader.indexOffset + uint64_t(batch.nIndices) * batch.indexSize;
+    if (fileOffset > UINT32_MAX) {
+      return false;
+    }
+  }
+
+  FILE* file = fopen(fileName, "wb");
+  if (file == NULL) return false;
+
+  bool success = (fwrite(&header, sizeof(header), 1, file) == 1);
+  success &= (fwrite(batchHeaders.data(), sizeof(CookedBatchHeader), batchHeaders.size(), file) == batchHeaders.size());
+
+  const uint8_t padding[16] = {};
+  for (size_t i = 0; i < cooked.batches.size() && success; i++) {
+    const Batch& batch = cooked.batches[i];
+    const CookedBatchHeader& batchHeader = batchHeaders[i];
+
+    size_t paddingSize = batchHeader.vertexOffset - (size_t)ftell(file);
+    success &= (fwrite(padding, 1, paddingSize, file) == paddingSize);
+    success &= (fwrite(batch.vertexData, COOKED_VERTEX_SIZE, batch.nVertices, file) == batch.nVertices);
+
+    paddingSize = batchHeader.indexOffset - (size_t)ftell(file);
+    success &= (fwrite(padding, 1, paddingSize, file) == paddingSize);
+    success &= (fwrite(batch.indexData, batch.indexSize, batch.nIndices, file) == batch.nIndices);
+  }
   fclose(file);
 
+  return success;
+}
+
+bool load_cooked_model(const char* fileName, const char* sourceFileName, const vec3& offset, Model& ret_model, vec3& ret_min, vec3& ret_max,
+                       std::vector<vec3>& ret_batchMin, std::vector<vec3>& ret_batchMax) {
+  ret_model.batches.resize(0);
+  uint64_t sourceSize = 0;
+  int64_t sourceTime = 0;
+  if (!get_file_info(sourceFileName, sourceSize, sourceTime)) return false;
+  if (!ret_model.file.open(fileName, true)) return false;
+
+  auto fail = [&]() {
+    ret_model.batches.resize(0);
+    ret_model.file.close();
+    return false;
+  };
+
+  uint8_t* data = ret_model.file.getData();
+  size_t size = ret_model.file.getSize();
+
+  CookedModelHeader header;
+  if (size < sizeof(header)) return fail();
+  memcpy(&header, data, sizeof(header));
+  if (header.fileId != COOKED_MODEL_FILE_ID ||
+      header.version != COOKED_MODEL_VERSION ||
+      header.sourceSize != sourceSize ||
+      header.sourceTime != sourceTime ||
+      header.batchCount > MAX_MODEL_BATCHES ||
+      glm::make_vec3(header.offset) != offset ||
+      sizeof(header) + uint64_t(header.batchCount) * sizeof(CookedBatchHeader) > size) {
+    return fail();
+  }
+
+  ret_model.batches.resize(header.batchCount);
+  ret_batchMin.resize(header.batchCount);
+  ret_batchMax.resize(header.batchCount);
+  for (uint32_t i = 0; i < header.batchCount; i++) {
+    CookedBatchHeader batchHeader;
+    memcpy(&batchHeader, data + sizeof(header) + i * sizeof(CookedBatchHeader), sizeof(batchHeader));
+
+    if (batchHeader.nVertices > MAX_BATCH_VERTICES ||
+        batchHeader.nIndices > MAX_BATCH_INDICES ||
+        (batchHeader.indexSize != sizeof(uint16_t) && batchHeader.indexSize != sizeof(uint32_t)) ||
+        batchHeader.vertexOffset + uint64_t(batchHeader.nVertices) * COOKED_VERTEX_SIZE > size ||
+        batchHeader.indexOffset + uint64_t(batchHeader.nIndices) * batchHeader.indexSize > size) {
+      return fail();
+    }
+
+    Batch& batch = ret_model.batches[i];
+    set_cooked_formats(batch);
+    batch.nVertices = batchHeader.nVertices;
+    batch.nIndices = batchHeader.nIndices;
+    batch.indexSize = batchHeader.indexSize;
+    batch.vertexData = data + batchHeader.vertexOffset;
+    batch.indexData = data + batchHeader.indexOffset;
+    ret_batchMin[i] = glm::make_vec3(batchHeader.boundsMin);
+    ret_batchMax[i] = glm::make_vec3(batchHeader.boundsMax);
+
+    bool validIndices = (batch.indexSize == sizeof(uint16_t)) ? validate_indices<uint16_t>(batch.indexData, batch.nIndices, batch.nVertices) :
+                                                                validate_indices<uint32_t>(batch.indexData, batch.nIndices, batch.nVertices);
+    if (!validIndices) return fail();
+  }
+
+  ret_min = glm::make_vec3(header.boundsMin);
+  ret_max = glm::make_vec3(header.boundsMax);
   return true;
 }
@@ -3,7 +3,18 @@
 
 #include "external/sokol_gfx.h"
 #include "Vector.h"
+#include "MappedFile.h"
 #include <vector>
+#include <string>
+
+const uint32_t MODEL_VERSION_1 = 1;
+
+// Limits on values read from model files
+const uint32_t MAX_MODEL_BATCHES = 1024;
+const uint32_t MAX_BATCH_FORMATS = 16;
+const uint32_t MAX_VERTEX_SIZE = 256;
+const uint32_t MAX_BATCH_VERTICES = 1 << 24;
+const uint32_t MAX_BATCH_INDICES = 1 << 26;
 
 enum PrimitiveType : uint32_t {
   PRIM_TRIANGLES = 0,
@@ -34,9 +45,12 @@ struct Format {
 
 struct Batch
 {
-  std::vector<uint8_t> vertices;
+  std::vector<uint8_t> vertices; // Vertex/index storage when not loaded from a file mapping
   std::vector<uint8_t> indices;
 
+  uint8_t* vertexData = nullptr; // Points into the storage above or into the model file mapping
+  uint8_t* indexData = nullptr;
+
   uint32_t nVertices = 0;
   uint32_t nIndices = 0;
   uint32_t vertexSize = 0;
@@ -47,17 +61,76 @@ struct Batch
 
   sg_buffer render_index = sg_buffer{ SG_INVALID_ID };
   sg_buffer render_vertex = sg_buffer{ SG_INVALID_ID };
+  uint32_t baseElement = 0; // First index of the batch in render_index (non-zero when packed with other batches)
 };
 
 struct Model
 {
   std::vector<Batch> batches;
+  MappedFile file; // Backing storage of the batch data when loaded with load_model_from_mapped_file
 };
 
 bool load_model_from_file(const char* fileName, Model& ret_model);
 bool make_model_renderable(Model& ret_model);
 
+// Upload the batches of all the models into one vertex buffer and one index buffer (all batches must be indexed and have the same vertex size).
+// The indices are rebased to the start of each batch in the shared vertex buffer, draw with Batch::baseElement.
+// The index size is 16 bit if the total vertex count allows it, otherwise 32 bit.
+bool make_models_renderable_packed(Model* const* models, uint32_t modelCount, uint32_t& ret_indexSize);
+
+// Load a model without copying the batch data (batches point into a copy-on-write mapping of the file)
+bool load_model_from_mapped_file(const char* fileName, Model& ret_model);
+
+// Load a model from file data in memory (batches point into the data, which must stay valid while the model is used).
+// All values are validated, so this is safe to call on untrusted data.
+bool load_model_from_memory(uint8_t* data, size_t size, Model& ret_model);
+
+// Release the CPU side vertex/index data (eg. once uploaded with make_model_renderable)
+void free_model_cpu_data(Model& ret_model);
+
 bool get_bounding_box(const Model& model, vec3& min, vec3& max);
+bool get_bounding_box(const Batch& batch, vec3& min, vec3& max); // Grows the passed bounds
 bool transform_model(Model& ret_model, const mat4& mat);
 
+// Cooked models have the world offset baked in and use a fixed vertex layout that is uploaded as is (see tools/ModelCooker.cpp)
+//   CookedModelHeader
+//   CookedBatchHeader[batchCount]
+//   Vertex and index data of each batch (16 byte aligned)
+const uint32_t COOKED_MODEL_FILE_ID = 0x444D4350; // "PCMD"
+const uint32_t COOKED_MODEL_VERSION = 2;
+const uint32_t COOKED_VERTEX_SIZE = 56; // position(float3), uv(float2), tangent frame(3 x float3)
+
+struct CookedModelHeader {
+  uint32_t fileId;
+  uint32_t version;
+  uint64_t sourceSize; // Source model file the model was cooked from (the cooked file is stale if these change)
+  int64_t sourceTime;
+  float offset[3]; // World offset baked into the positions
+  float boundsMin[3];
+  float boundsMax[3];
+  uint32_t batchCount;
+};
+
+struct CookedBatchHeader {
+  uint32_t nVertices;
+  uint32_t nIndices;
+  uint32_t indexSize;
+  uint32_t vertexOffset; // File offsets of the data
+  uint32_t indexOffset;
+  float boundsMin[3];
+  float boundsMax[3];
+};
+
+// Get the cooked file name for a model file (extension replaced with .cmdl)
+std::string get_cooked_model_name(const char* fileName);
+
+// Convert a model to the cooked layout with the offset applied (triangles with 16 bit indices where possible)
+bool cook_model(const Model& model, const vec3& offset, Model& ret_cooked);
+bool save_cooked_model(const char* fileName, const char* sourceFileName, const Model& cooked, const vec3& offset);
+
+// Load a cooked model (batches point into a mapping of the file) with the bounds of the model and each batch.
+// Fails if it was not cooked with the passed offset, or the source file changed since it was cooked.
+bool load_cooked_model(const char* fileName, const char* sourceFileName, const vec3& offset, Model& ret_model, vec3& ret_min, vec3& ret_max,
+                       std::vector<vec3>& ret_batchMin, std::vector<vec3>& ret_batchMax);
+
 #endif // _MODEL_H_
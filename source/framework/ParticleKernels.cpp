@@ -0,0 +1,173 @@
+#include "ParticleKernels.h"
+#include <math.h>
+
+// The AVX kernel is compiled for AVX regardless of the build target, and only used when the CPU supports it
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PARTICLE_KERNEL_AVX
+#define AVX_TARGET
+#elif defined(__GNUC__) || defined(__clang__)
+#include <immintrin.h>
+#define PARTICLE_KERNEL_AVX
+#define AVX_TARGET __attribute__((target("avx")))
+#endif
+#endif // GLM_ARCH_SSE2_BIT
+
+void integrate_particles_scalar(const ParticleIntegration& params, const ParticleStreams& streams, uint32_t start, uint32_t count) {
+  const uint32_t end = start + count;
+  for (uint32_t i = start; i < end; i++) {
+    float vx = 0.0f;
+    float vy = 0.0f;
+    float vz = 0.0f;
+    for (uint32_t j = 0; j < params.pointForceCount; j++) {
+      const PointForce& pf = params.pointForces[j];
+      float dx = pf.pos.x - streams.posX[i];
+      float dy = pf.pos.y - streams.posY[i];
+      float dz = pf.pos.z - streams.posZ[i];
+      float dist = dx * dx + dy * dy + dz * dz;
+      float scale = pf.strength / (1.0f + sqrtf(dist) * pf.linearAttenuation + dist * pf.quadraticAttenuation);
+      vx += dx * scale;
+      vy += dy * scale;
+      vz += dz * scale;
+    }
+
+    streams.dirX[i] = (streams.dirX[i] + (params.directionalForce.x + vx) * params.time) * params.friction;
+    streams.dirY[i] = (streams.dirY[i] + (params.directionalForce.y + vy) * params.time) * params.friction;
+    streams.dirZ[i] = (streams.dirZ[i] + (params.directionalForce.z + vz) * params.time) * params.friction;
+
+    streams.posX[i] += streams.dirX[i] * params.time;
+    streams.posY[i] += streams.dirY[i] * params.time;
+    streams.posZ[i] += streams.dirZ[i] * params.time;
+  }
+}
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+// dir = (dir + (df + v) * time) * friction, pos += dir * time
+static inline void integrate_axis_sse2(float* pos, float* dir, __m128 p, __m128 df, __m128 v, __m128 time, __m128 friction) {
+  __m128 d = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(dir), _mm_mul_ps(_mm_add_ps(df, v), time)), friction);
+  _mm_storeu_ps(dir, d);
+  _mm_storeu_ps(pos, _mm_add_ps(p, _mm_mul_ps(d, time)));
+}
+
+static void integrate_particles_sse2(const ParticleIntegration& params, const ParticleStreams& streams, uint32_t start, uint32_t count) {
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 time = _mm_set1_ps(params.time);
+  const __m128 friction = _mm_set1_ps(params.friction);
+  const __m128 dfX = _mm_set1_ps(params.directionalForce.x);
+  const __m128 dfY = _mm_set1_ps(params.directionalForce.y);
+  const __m128 dfZ = _mm_set1_ps(params.directionalForce.z);
+
+  const uint32_t end = start + count;
+  uint32_t i = start;
+  for (; i + 4 <= end; i += 4) {
+    __m128 px = _mm_loadu_ps(streams.posX + i);
+    __m128 py = _mm_loadu_ps(streams.posY + i);
+    __m128 pz = _mm_loadu_ps(streams.posZ + i);
+
+    __m128 vx = _mm_setzero_ps();
+    __m128 vy = _mm_setzero_ps();
+    __m128 vz = _mm_setzero_ps();
+    for (uint32_t j = 0; j < params.pointForceCount; j++) {
+      const PointForce& pf = params.pointForces[j];
+      __m128 dx = _mm_sub_ps(_mm_set1_ps(pf.pos.x), px);
+      __m128 dy = _mm_sub_ps(_mm_set1_ps(pf.pos.y), py);
+      __m128 dz = _mm_sub_ps(_mm_set1_ps(pf.pos.z), pz);
+      __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+      __m128 atten = _mm_add_ps(_mm_add_ps(one, _mm_mul_ps(_mm_sqrt_ps(dist), _mm_set1_ps(pf.linearAttenuation))),
+                                _mm_mul_ps(dist, _mm_set1_ps(pf.quadraticAttenuation)));
+      __m128 scale = _mm_div_ps(_mm_set1_ps(pf.strength), atten);
+      vx = _mm_add_ps(vx, _mm_mul_ps(dx, scale));
+      vy = _mm_add_ps(vy, _mm_mul_ps(dy, scale));
+      vz = _mm_add_ps(vz, _mm_mul_ps(dz, scale));
+    }
+
+    integrate_axis_sse2(streams.posX + i, streams.dirX + i, px, dfX, vx, time, friction);
+    integrate_axis_sse2(streams.posY + i, streams.dirY + i, py, dfY, vy, time, friction);
+    integrate_axis_sse2(streams.posZ + i, streams.dirZ + i, pz, dfZ, vz, time, friction);
+  }
+
+  integrate_particles_scalar(params, streams, i, end - i);
+}
+
+#endif // GLM_ARCH_SSE2_BIT
+
+#ifdef PARTICLE_KERNEL_AVX
+
+// Same as the SSE2 kernel, 8 particles per iteration. FMA is not used so the results match the other kernels.
+AVX_TARGET static inline void integrate_axis_avx(float* pos, float* dir, __m256 p, __m256 df, __m256 v, __m256 time, __m256 friction) {
+  __m256 d = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(dir), _mm256_mul_ps(_mm256_add_ps(df, v), time)), friction);
+  _mm256_storeu_ps(dir, d);
+  _mm256_storeu_ps(pos, _mm256_add_ps(p, _mm256_mul_ps(d, time)));
+}
+
+AVX_TARGET static void integrate_particles_avx(const ParticleIntegration& params, const ParticleStreams& streams, uint32_t start, uint32_t count) {
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 time = _mm256_set1_ps(params.time);
+  const __m256 friction = _mm256_set1_ps(params.friction);
+  const __m256 dfX = _mm256_set1_ps(params.directionalForce.x);
+  const __m256 dfY = _mm256_set1_ps(params.directionalForce.y);
+  const __m256 dfZ = _mm256_set1_ps(params.directionalForce.z);
+
+  const uint32_t end = start + count;
+  uint32_t i = start;
+  for (; i + 8 <= end; i += 8) {
+    __m256 px = _mm256_loadu_ps(streams.posX + i);
+    __m256 py = _mm256_loadu_ps(streams.posY + i);
+    __m256 pz = _mm256_loadu_ps(streams.posZ + i);
+
+    __m256 vx = _mm256_setzero_ps();
+    __m256 vy = _mm256_setzero_ps();
+    __m256 vz = _mm256_setzero_ps();
+    for (uint32_t j = 0; j < params.pointForceCount; j++) {
+      const PointForce& pf = params.pointForces[j];
+      __m256 dx = _mm256_sub_ps(_mm256_set1_ps(pf.pos.x), px);
+      __m256 dy = _mm256_sub_ps(_mm256_set1_ps(pf.pos.y), py);
+      __m256 dz = _mm256_sub_ps(_mm256_set1_ps(pf.pos.z), pz);
+      __m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+      __m256 atten = _mm256_add_ps(_mm256_add_ps(one, _mm256_mul_ps(_mm256_sqrt_ps(dist), _mm256_set1_ps(pf.linearAttenuation))),
+                                   _mm256_mul_ps(dist, _mm256_set1_ps(pf.quadraticAttenuation)));
+      __m256 scale = _mm256_div_ps(_mm256_set1_ps(pf.strength), atten);
+      vx = _mm256_add_ps(vx, _mm256_mul_ps(dx, scale));
+      vy = _mm256_add_ps(vy, _mm256_mul_ps(dy, scale));
+      vz = _mm256_add_ps(vz, _mm256_mul_ps(dz, scale));
+    }
+
+    integrate_axis_avx(streams.posX + i, streams.dirX + i, px, dfX, vx, time, friction);
+    integrate_axis_avx(streams.posY + i, streams.dirY + i, py, dfY, vy, time, friction);
+    integrate_axis_avx(streams.posZ + i, streams.dirZ + i, pz, dfZ, vz, time, friction);
+  }
+
+  integrate_particles_sse2(params, streams, i, end - i);
+}
+
+static bool cpu_supports_avx() {
+#if defined(_MSC_VER)
+  // AVX and OS support for saving the YMM registers
+  int info[4];
+  __cpuid(info, 1);
+  const int avxBits = (1 << 27) | (1 << 28);
+  if ((info[2] & avxBits) != avxBits) return false;
+  return (_xgetbv(0) & 6) == 6;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx") != 0;
+#endif
+}
+
+#endif // PARTICLE_KERNEL_AVX
+
+IntegrateParticlesFunc get_integrate_particles_func() {
+  static const IntegrateParticlesFunc func = []() -> IntegrateParticlesFunc {
+#ifdef PARTICLE_KERNEL_AVX
+    if (cpu_supports_avx()) return integrate_particles_avx;
+#endif // PARTICLE_KERNEL_AVX
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    return integrate_particles_sse2;
+#else
+    return integrate_particles_scalar;
+#endif // GLM_ARCH_SSE2_BIT
+  }();
+  return func;
+}
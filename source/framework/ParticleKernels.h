@@ -0,0 +1,34 @@
+#ifndef _PARTICLE_KERNELS_H_
+#define _PARTICLE_KERNELS_H_
+
+#include "ParticleSystem.h"
+
+// Per update constants of the particle integration
+struct ParticleIntegration {
+  vec3 directionalForce;
+  float friction;   // Friction factor scaled to the time step
+  float time;
+  const PointForce* pointForces;
+  uint32_t pointForceCount;
+};
+
+// Particle arrays the integration reads and writes
+struct ParticleStreams {
+  float* posX;
+  float* posY;
+  float* posZ;
+  float* dirX;
+  float* dirY;
+  float* dirZ;
+};
+
+// Applies the point and directional forces and friction to the directions, then moves the positions of the particles [start, start + count).
+// All kernels give identical results, so the choice of kernel does not change the simulation.
+typedef void (*IntegrateParticlesFunc)(const ParticleIntegration& params, const ParticleStreams& streams, uint32_t start, uint32_t count);
+
+void integrate_particles_scalar(const ParticleIntegration& params, const ParticleStreams& streams, uint32_t start, uint32_t count);
+
+// Widest kernel the CPU supports (AVX, SSE2 or scalar), selected on first call
+IntegrateParticlesFunc get_integrate_particles_func();
+
+#endif // _PARTICLE_KERNELS_H_
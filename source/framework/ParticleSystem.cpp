@@ -14,16 +14,73 @@
 \*********************************************************************/
 
 #include "ParticleSystem.h"
-#include <stdlib.h>
+#include "ParticleKernels.h"
+#include <string.h>
 #include <math.h>
 #include <algorithm>
 
-float random(float mean, float diff){
-	float r = 2 * (rand() / float(RAND_MAX)) - 1.0f;
-	
+void ParticleRandom::setSeed(const unsigned int seed){
+	// Spread the seed over the streams (splitmix32), a stream must not be zero
+	uint32_t x = seed;
+	for (int i = 0; i < 4; i++){
+		x += 0x9E3779B9;
+		uint32_t z = x;
+		z = (z ^ (z >> 16)) * 0x85EBCA6B;
+		z = (z ^ (z >> 13)) * 0xC2B2AE35;
+		z ^= z >> 16;
+		state[i] = z? z : 0x6D2B79F5;
+	}
+	lane = 0;
+}
+
+float ParticleRandom::random(const float mean, const float diff){
+	uint32_t x = state[lane];
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	state[lane] = x;
+	lane = (lane + 1) & 3;
+
+	// Mantissa bits make a float in [2, 4), giving r in [-1, 1)
+	uint32_t bits = (x >> 9) | 0x40000000;
+	float r;
+	memcpy(&r, &bits, sizeof(r));
+	r -= 3.0f;
+
 	return mean + r * fabsf(r) * diff;
 }
 
+void ParticleRandom::random(float *dest, const unsigned int count, const float mean, const float diff){
+	unsigned int i = 0;
+
+	// Align to the first stream so the batch continues the sequence
+	for (; i < count && lane != 0; i++){
+		dest[i] = random(mean, diff);
+	}
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	__m128i x = _mm_loadu_si128((const __m128i *) state);
+	const __m128i exponent = _mm_set1_epi32(0x40000000);
+	const __m128 three = _mm_set1_ps(3.0f);
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 vMean = _mm_set1_ps(mean);
+	const __m128 vDiff = _mm_set1_ps(diff);
+	for (; i + 4 <= count; i += 4){
+		x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+		x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+		x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+
+		__m128 r = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(x, 9), exponent)), three);
+		_mm_storeu_ps(dest + i, _mm_add_ps(vMean, _mm_mul_ps(_mm_mul_ps(r, _mm_and_ps(r, absMask)), vDiff)));
+	}
+	_mm_storeu_si128((__m128i *) state, x);
+#endif // GLM_ARCH_SSE2_BIT
+
+	for (; i < count; i++){
+		dest[i] = random(mean, diff);
+	}
+}
+
 
 ParticleSystem::ParticleSystem(){
 	pos = vec3(0, 0, 0);
@@ -46,6 +103,9 @@ ParticleSystem::ParticleSystem(){
 	lastTime = 0;
 	particleCredit = 0;
 
+	boundsCenter = pos;
+	boundsRadius = 0;
+
 	rotate = false;
 }
 
@@ -90,23 +150,79 @@ void ParticleSystem::setColorScheme(const COLOR_SCHEME colorScheme){
 	}
 }
 
-void ParticleSystem::initParticle(Particle &p){
-	p.pos = pos;
-	p.dir = normalize(vec3(random(0, 0.3f), 1, random(0, 0.3f)));
-	p.dir *= random(speed, speedSpread);
-	p.size = random(size, sizeSpread);
-	/*p.initialLife = */p.life = random(life, lifeSpread);
-	p.invInitialLife = 1.0f / p.life;
+void ParticleSystem::spawnParticles(const unsigned int count){
+	unsigned int first = getParticleCount();
+	unsigned int total = first + count;
+
+	std::vector <float> *arrays[] = { &posX, &posY, &posZ, &dirX, &dirY, &dirZ, &sizes, &lives, &invInitialLives, &angles, &angleSpeeds, &depths };
+	for (std::vector <float> *array : arrays){
+		array->resize(total);
+	}
+
+	// Draw the random values in batches, the speeds go to the sort scratch array
+	sortTemp.resize(count);
+	rng.random(&dirX[first], count, 0, 0.3f);
+	rng.random(&dirZ[first], count, 0, 0.3f);
+	rng.random(sortTemp.data(), count, speed, speedSpread);
+	rng.random(&sizes[first], count, size, sizeSpread);
+	rng.random(&lives[first], count, life, lifeSpread);
+
+	for (unsigned int i = first; i < total; i++){
+		vec3 dir = normalize(vec3(dirX[i], 1, dirZ[i])) * sortTemp[i - first];
+
+		posX[i] = pos.x;
+		posY[i] = pos.y;
+		posZ[i] = pos.z;
+		dirX[i] = dir.x;
+		dirY[i] = dir.y;
+		dirZ[i] = dir.z;
+		invInitialLives[i] = 1.0f / lives[i];
+		angles[i] = 0;
+		angleSpeeds[i] = 0;
+		depths[i] = 0;
+	}
+}
+
+void ParticleSystem::addParticle(const Particle &p){
+	posX.push_back(p.pos.x);
+	posY.push_back(p.pos.y);
+	posZ.push_back(p.pos.z);
+	dirX.push_back(p.dir.x);
+	dirY.push_back(p.dir.y);
+	dirZ.push_back(p.dir.z);
+	sizes.push_back(p.size);
+	lives.push_back(p.life);
+	invInitialLives.push_back(p.invInitialLife);
+	angles.push_back(p.angle);
+	angleSpeeds.push_back(p.angleSpeed);
+	depths.push_back(p.depth);
+}
+
+void ParticleSystem::removeParticle(const unsigned int index){
+	std::vector <float> *arrays[] = { &posX, &posY, &posZ, &dirX, &dirY, &dirZ, &sizes, &lives, &invInitialLives, &angles, &angleSpeeds, &depths };
+	for (std::vector <float> *array : arrays){
+		(*array)[index] = array->back();
+		array->pop_back();
+	}
 }
 
-void ParticleSystem::updateParticle(Particle &p, const float time){
-	p.pos += p.dir * time;
+void ParticleSystem::updateParticles(const float time){
+	ParticleIntegration params;
+	params.directionalForce = directionalForce;
+	params.friction = powf(frictionFactor, time);
+	params.time = time;
+	params.pointForces = pointForces.data();
+	params.pointForceCount = (uint32_t) pointForces.size();
+
+	ParticleStreams streams = { posX.data(), posY.data(), posZ.data(), dirX.data(), dirY.data(), dirZ.data() };
+
+	IntegrateParticlesFunc integrateParticles = get_integrate_particles_func();
+	integrateParticles(params, streams, 0, getParticleCount());
 }
 
 void ParticleSystem::update(const float timeStamp){
-	Particle p;
-	float time, dist, friction;
-	unsigned int i, j, len;
+	float time;
+	unsigned int i, len;
 
 	time = timeStamp - lastTime;
 	lastTime = timeStamp;
@@ -115,54 +231,141 @@ void ParticleSystem::update(const float timeStamp){
 	len = (int) particleCredit;
 	particleCredit -= len;
 
-	particles.reserve(particles.size() + len);
-	for (i = 0; i < len; i++){
-		initParticle(p);
-		particles.push_back(p);
+	if (len > 0){
+		spawnParticles(len);
 	}
 
-	friction = powf(frictionFactor, time);
-
+	// Remove the dead particles first so the remaining passes run over packed arrays
 	i = 0;
-	while (i < particles.size()){
-		if ((particles[i].life -= time) < 0){
-			particles.erase(particles.begin() + i);
+	while (i < getParticleCount()){
+		if ((lives[i] -= time) < 0){
+			removeParticle(i);
 			continue;
 		}
+		i++;
+	}
 
-		vec3 v(0, 0, 0);
-		for (j = 0; j < pointForces.size(); j++){
-			vec3 dir = pointForces[j].pos - particles[i].pos;
-			dist = dot(dir, dir);
-			v += dir * (pointForces[j].strength / (1.0f + sqrtf(dist) * pointForces[j].linearAttenuation + dist * pointForces[j].quadraticAttenuation));
+	len = getParticleCount();
+	if (rotate){
+		for (i = 0; i < len; i++){
+			angles[i] += angleSpeeds[i] * time;
 		}
+	}
 
-		particles[i].dir += (directionalForce + v) * time;
-		particles[i].dir *= friction;
-		if (rotate) particles[i].angle += particles[i].angleSpeed * time;
+	updateParticles(time);
+	updateBounds();
+}
 
-		//particles[i].pos += particles[i].dir * time;
-		updateParticle(particles[i], time);
+void ParticleSystem::updateBounds(){
+	unsigned int count = getParticleCount();
+	if (count == 0){
+		boundsCenter = pos;
+		boundsRadius = 0;
+		return;
+	}
 
-		i++;
+	float minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+	float maxX = -FLT_MAX, maxY = -FLT_MAX, maxZ = -FLT_MAX;
+	float maxSize = 0;
+	for (unsigned int i = 0; i < count; i++){
+		minX = min(minX, posX[i]);
+		minY = min(minY, posY[i]);
+		minZ = min(minZ, posZ[i]);
+		maxX = max(maxX, posX[i]);
+		maxY = max(maxY, posY[i]);
+		maxZ = max(maxZ, posZ[i]);
+		maxSize = max(maxSize, sizes[i]);
 	}
+
+	// Billboard corners are up to size * sqrt(2) from the particle
+	vec3 boxMin(minX, minY, minZ), boxMax(maxX, maxY, maxZ);
+	boundsCenter = (boxMin + boxMax) * 0.5f;
+	boundsRadius = length(boxMax - boxMin) * 0.5f + maxSize * 1.4142136f;
+}
+
+void ParticleSystem::getBoundingSphere(vec3 &center, float &radius) const {
+	// The emitter may have moved since the last update, and spawns particles up to the maximum size
+	center = boundsCenter;
+	radius = max(boundsRadius, length(pos - boundsCenter) + (size + sizeSpread) * 1.4142136f);
 }
 
 void ParticleSystem::updateTime(const float timeStamp){
 	lastTime = timeStamp;
 }
 
-int depthComp(const Particle &elem0, const Particle &elem1){
-	return (elem0.depth < elem1.depth);
+// Insertion sort of the indices by depth, returns false if more than maxMoves moves are needed
+static bool insertionSortIndices(unsigned int *indices, const unsigned int count, const float *depths, unsigned int maxMoves){
+	for (unsigned int i = 1; i < count; i++){
+		unsigned int index = indices[i];
+		float depth = depths[index];
+
+		unsigned int j = i;
+		while (j > 0 && depths[indices[j - 1]] > depth){
+			if (maxMoves-- == 0) return false;
+			indices[j] = indices[j - 1];
+			j--;
+		}
+		indices[j] = index;
+	}
+	return true;
+}
+
+// LSD radix sort of the indices by depth, 3 passes of 11 bits (the depths are not negative, so their bits sort as integers)
+static void radixSortIndices(std::vector <unsigned int> &indices, std::vector <unsigned int> &temp, const float *depths){
+	unsigned int count = (unsigned int) indices.size();
+	temp.resize(count);
+
+	for (unsigned int i = 0; i < count; i++){
+		indices[i] = i;
+	}
+
+	for (unsigned int shift = 0; shift < 33; shift += 11){
+		unsigned int offsets[2048] = {};
+		for (unsigned int i = 0; i < count; i++){
+			uint32_t key;
+			memcpy(&key, &depths[i], sizeof(key));
+			offsets[(key >> shift) & 2047]++;
+		}
+
+		unsigned int sum = 0;
+		for (unsigned int b = 0; b < 2048; b++){
+			unsigned int n = offsets[b];
+			offsets[b] = sum;
+			sum += n;
+		}
+
+		for (unsigned int i = 0; i < count; i++){
+			uint32_t key;
+			memcpy(&key, &depths[indices[i]], sizeof(key));
+			temp[offsets[(key >> shift) & 2047]++] = indices[i];
+		}
+		indices.swap(temp);
+	}
 }
 
 void ParticleSystem::depthSort(const vec3 &pos, const vec3 &depthAxis){
-	for (unsigned int i = 0; i < particles.size(); i++){
-		particles[i].depth = fabsf(dot(particles[i].pos - pos, depthAxis));
+	unsigned int count = getParticleCount();
+	sortIndices.resize(count);
+	for (unsigned int i = 0; i < count; i++){
+		depths[i] = fabsf(dot(vec3(posX[i], posY[i], posZ[i]) - pos, depthAxis));
+		sortIndices[i] = i;
+	}
+
+	// The arrays keep the order of the last sort, so usually only a few particles (spawned, swapped in on removal or overtaken) are out of place.
+	// Insertion sort fixes that in close to linear time, a radix sort is used when the order has changed a lot.
+	if (!insertionSortIndices(sortIndices.data(), count, depths.data(), 4 * count)){
+		radixSortIndices(sortIndices, sortTempIndices, depths.data());
+	}
+
+	// Apply the order to every array
+	std::vector <float> *arrays[] = { &posX, &posY, &posZ, &dirX, &dirY, &dirZ, &sizes, &lives, &invInitialLives, &angles, &angleSpeeds, &depths };
+	sortTemp.resize(count);
+	for (std::vector <float> *array : arrays){
+		for (unsigned int i = 0; i < count; i++){
+			sortTemp[i] = (*array)[sortIndices[i]];
+		}
+		array->swap(sortTemp);
 	}
-	
-	std::sort(particles.begin(), particles.end(), depthComp);
-	//particles.sort(depthComp);
 }
 
 void ParticleSystem::getVertexArray(std::vector<uint8_t>& buffer, const vec3 &dx, const vec3 &dy, bool useColors, bool tex3d) const {
@@ -170,7 +373,7 @@ void ParticleSystem::getVertexArray(std::vector<uint8_t>& buffer, const vec3 &dx
 	if (useColors) vertexSize += sizeof(vec4);
 	if (tex3d) vertexSize += sizeof(float);
 
-	unsigned int size = (unsigned int)particles.size() * vertexSize * 4;
+	unsigned int size = getParticleCount() * vertexSize * 4;
 	buffer.resize(size);
 
 	fillVertexArray(buffer.data(), dx, dy, useColors, tex3d);
@@ -179,19 +382,19 @@ void ParticleSystem::getVertexArray(std::vector<uint8_t>& buffer, const vec3 &dx
 void ParticleSystem::getPointSpriteArray(std::vector<uint8_t>& buffer, bool useColors) const {
 	unsigned int vertexSize = sizeof(vec3) + sizeof(float);
 	if (useColors) vertexSize += sizeof(vec4);
-	unsigned int size = vertexSize * (unsigned int)particles.size();
+	unsigned int size = vertexSize * getParticleCount();
 	buffer.resize(size);
 
 	uint8_t *dest = buffer.data();
-	for (unsigned int i = 0; i < particles.size(); i++){
-		*(vec3 *) dest = particles[i].pos;
+	for (unsigned int i = 0; i < getParticleCount(); i++){
+		*(vec3 *) dest = vec3(posX[i], posY[i], posZ[i]);
 		dest += sizeof(vec3);
-		*(float *) dest = particles[i].size;
+		*(float *) dest = sizes[i];
 		dest += sizeof(float);
 
 		if (useColors){
 			//float colFrac = (11.0f * particles[i].life) / particles[i].initialLife;
-			float colFrac = 11.0f * particles[i].life * particles[i].invInitialLife;
+			float colFrac = 11.0f * lives[i] * invInitialLives[i];
 
 			int colInt = (int) colFrac;
 			colFrac -= colInt;
@@ -203,20 +406,24 @@ void ParticleSystem::getPointSpriteArray(std::vector<uint8_t>& buffer, bool useC
 }
 
 void ParticleSystem::getIndexArray(std::vector<uint16_t>& buffer) const {
-	size_t size = particles.size() * 6;
+	size_t size = size_t(getParticleCount()) * 6;
 	buffer.resize(size);
 	fillIndexArray(buffer.data());
 }
 
 void ParticleSystem::fillVertexArray(uint8_t *dest, const vec3 &dx, const vec3 &dy, bool useColors, bool tex3d) const {
+	fillVertexArrayRange(dest, dx, dy, 0, getParticleCount(), useColors, tex3d);
+}
+
+void ParticleSystem::fillVertexArrayRange(uint8_t *dest, const vec3 &dx, const vec3 &dy, const unsigned int start, unsigned int count, bool useColors, bool tex3d) const {
 	static vec2 coords[4] = { vec2(0, 0), vec2(1, 0), vec2(1, 1), vec2(0, 1) };
 	vec3 vect[4] = { -dx + dy, dx + dy, dx - dy, -dx - dy };
 
 	float frac = 0;
 	vec4 color;
-	for (unsigned int i = 0; i < particles.size(); i++){
+	for (unsigned int i = start; i < start + count; i++){
 		if (useColors || tex3d)
-			frac = particles[i].life * particles[i].invInitialLife;
+			frac = lives[i] * invInitialLives[i];
 //			frac = particles[i].life / particles[i].initialLife;
 
 		if (useColors){
@@ -228,8 +435,8 @@ void ParticleSystem::fillVertexArray(uint8_t *dest, const vec3 &dx, const vec3 &
 		}
 
 		if (rotate){
-			float fx = 1.4142136f * cosf(particles[i].angle);
-			float fy = 1.4142136f * sinf(particles[i].angle);
+			float fx = 1.4142136f * cosf(angles[i]);
+			float fy = 1.4142136f * sinf(angles[i]);
 		
 			for (unsigned int k = 0; k < 4; k++){
 				vect[k] = fx * dx + fy * dy;
@@ -240,8 +447,9 @@ void ParticleSystem::fillVertexArray(uint8_t *dest, const vec3 &dx, const vec3 &
 			}
 		}
 
+		vec3 pos(posX[i], posY[i], posZ[i]);
 		for (unsigned int j = 0; j < 4; j++){
-			*(vec3 *) dest = particles[i].pos + particles[i].size * vect[j];
+			*(vec3 *) dest = pos + sizes[i] * vect[j];
 			dest += sizeof(vec3);
 			*(vec2 *) dest = coords[j];
 			dest += sizeof(vec2);
@@ -260,44 +468,35 @@ void ParticleSystem::fillVertexArray(uint8_t *dest, const vec3 &dx, const vec3 &
 }
 
 void ParticleSystem::fillInstanceVertexArray(uint8_t* dest) const{
-	const Particle *part = particles.data();
-	for (unsigned int i = 0; i < particles.size(); i++){
-		*(vec3 *) dest = part->pos;
+	for (unsigned int i = 0; i < getParticleCount(); i++){
+		*(vec3 *) dest = vec3(posX[i], posY[i], posZ[i]);
 		dest += sizeof(vec3);
-		*(float *) dest = part->size;
+		*(float *) dest = sizes[i];
 		dest += sizeof(float);
 
-		float colFrac = 11.0f * part->life * part->invInitialLife;
+		float colFrac = 11.0f * lives[i] * invInitialLives[i];
 		int colInt = (int) colFrac;
 		colFrac -= colInt;
 
 		*(vec4 *) dest = lerp(colors[colInt], colors[colInt + 1], colFrac);
 		dest += sizeof(vec4);
-
-		part++;
 	}
 }
 
 void ParticleSystem::fillInstanceVertexArrayRange(vec4 *posAndSize, vec4 *color, const unsigned int start, unsigned int count) const{
-	const Particle *part = particles.data() + start;
-
-	for (unsigned int i = 0; i < count; i++){
-		*(vec3 *) posAndSize = part->pos;
-		posAndSize->w = part->size;
-		posAndSize++;
+	for (unsigned int i = start; i < start + count; i++){
+		*posAndSize++ = vec4(posX[i], posY[i], posZ[i], sizes[i]);
 
-		float colFrac = 11.0f * part->life * part->invInitialLife;
+		float colFrac = 11.0f * lives[i] * invInitialLives[i];
 		int colInt = (int) colFrac;
 		colFrac -= colInt;
 
 		*color++ = lerp(colors[colInt], colors[colInt + 1], colFrac);
-
-		part++;
 	}
 }
 
 void ParticleSystem::fillIndexArray(uint16_t *dest) const{
-	for (unsigned int i = 0; i < particles.size(); i++){
+	for (unsigned int i = 0; i < getParticleCount(); i++){
 		*dest++ = 4 * i;
 		*dest++ = 4 * i + 1;
 		*dest++ = 4 * i + 3;
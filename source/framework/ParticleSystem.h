@@ -48,15 +48,31 @@ struct PointForce {
 	float quadraticAttenuation;
 };
 
-float random(float mean, float diff);
+// Seeded random numbers for the particle systems, four interleaved xorshift32 streams so batches can be drawn with SIMD.
+// Single and batch draws give the same sequence.
+class ParticleRandom {
+public:
+	ParticleRandom(const unsigned int seed = 1){ setSeed(seed); }
+
+	void setSeed(const unsigned int seed);
+
+	// mean + r * |r| * diff, with r uniform in [-1, 1)
+	float random(const float mean, const float diff);
+	void random(float *dest, const unsigned int count, const float mean, const float diff);
+
+protected:
+	uint32_t state[4];
+	unsigned int lane;
+};
 
 class ParticleSystem {
 public:
 	ParticleSystem();
 
 	const vec3 &getPosition() const { return pos; }
-	uint32_t getParticleCount() const { return (uint32_t)particles.size(); }
+	uint32_t getParticleCount() const { return (uint32_t)posX.size(); }
 	void setPosition(const vec3 &position){ pos = position; }
+	void setSeed(const unsigned int seed){ rng.setSeed(seed); }
 	void setSpawnRate(const float spawnrate){ spawnRate = spawnrate; }
 
 	void setSpeed(const float meanSpeed, const float spread){
@@ -88,20 +104,47 @@ public:
 	void updateTime(const float timeStamp);
 	void depthSort(const vec3 &pos, const vec3 &depthAxis);
 
+	// Sphere around the particles of the last update, grown to include the current emitter position
+	void getBoundingSphere(vec3 &center, float &radius) const;
+
 	void getVertexArray(std::vector<uint8_t>& buffer, const vec3 &dx, const vec3 &dy, bool useColors = true, bool tex3d = false) const;
 	void getPointSpriteArray(std::vector<uint8_t>& buffer, bool useColors = true) const;
 	void getIndexArray(std::vector<uint16_t>& buffer) const;
 
 	void fillVertexArray(uint8_t* dest, const vec3 &dx, const vec3 &dy, bool useColors = true, bool tex3d = false) const;
+	void fillVertexArrayRange(uint8_t* dest, const vec3 &dx, const vec3 &dy, const unsigned int start, unsigned int count, bool useColors = true, bool tex3d = false) const;
 	void fillInstanceVertexArray(uint8_t* dest) const;
 	void fillInstanceVertexArrayRange(vec4 *posAndSize, vec4 *color, const unsigned int start, unsigned int count) const;
 	void fillIndexArray(uint16_t *dest) const;
 
 protected:
-	virtual void initParticle(Particle &p);
-	virtual void updateParticle(Particle &p, const float time);
+	// Adds count new particles
+	virtual void spawnParticles(const unsigned int count);
+	// Moves all particles, called once per update. The default applies the forces and friction with the widest SIMD kernel the CPU supports.
+	virtual void updateParticles(const float time);
+
+	void addParticle(const Particle &p);
+	void removeParticle(const unsigned int index);
+	void updateBounds();
+
+	// Particles are stored as a structure of arrays, removal swaps the last particle into place
+	std::vector <float> posX, posY, posZ;
+	std::vector <float> dirX, dirY, dirZ;
+	std::vector <float> sizes;
+	std::vector <float> lives;
+	std::vector <float> invInitialLives;
+	std::vector <float> angles;
+	std::vector <float> angleSpeeds;
+	std::vector <float> depths;
+
+	std::vector <unsigned int> sortIndices, sortTempIndices;
+	std::vector <float> sortTemp;
+
+	vec3 boundsCenter;
+	float boundsRadius;
+
+	ParticleRandom rng;
 
-	std::vector <Particle> particles;
 	std::vector <PointForce> pointForces;
 	vec3 directionalForce;
 	
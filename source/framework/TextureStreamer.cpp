@@ -0,0 +1,193 @@
+#include "TextureStreamer.h"
+#include "ImageCache.h"
+#include <algorithm>
+#include <thread>
+
+TextureStreamer::~TextureStreamer() {
+  shutdown();
+}
+
+void TextureStreamer::init(JobSystem* in_jobSystem, uint64_t in_budgetBytes, uint32_t in_maxLoadsInFlight) {
+  jobSystem = in_jobSystem;
+  budgetBytes = in_budgetBytes;
+  maxLoadsInFlight = (in_maxLoadsInFlight > 0) ? in_maxLoadsInFlight : 1;
+
+  // Workers can not query sokol, so note which of the loadable formats can be used
+  const sg_pixel_format loadFormats[] = { SG_PIXELFORMAT_RGBA8, SG_PIXELFORMAT_BC1_RGBA, SG_PIXELFORMAT_BC3_RGBA, SG_PIXELFORMAT_BC5_RG };
+  for (sg_pixel_format format : loadFormats) {
+    formatSupported[format] = sg_query_pixelformat(format).sample;
+  }
+}
+
+void TextureStreamer::shutdown() {
+
+  // The load jobs reference the textures
+  while (loadsInFlight.load() > 0) {
+    std::this_thread::yield();
+  }
+
+  // Failed loads hold the shared placeholder, which is destroyed below
+  for (std::unique_ptr<StreamedTexture>& texture : textures) {
+    if (texture->image.id != SG_INVALID_ID && texture->image.id != texture->placeholder.id) {
+      sg_destroy_image(texture->image);
+    }
+    free_image_data(texture->data);
+  }
+  textures.clear();
+
+  for (std::pair<uint32_t, sg_image>& placeholder : placeholders) {
+    sg_destroy_image(placeholder.second);
+  }
+  placeholders.clear();
+
+  residentBytes = 0;
+  residentCount = 0;
+}
+
+sg_image TextureStreamer::getPlaceholder(uint32_t color) {
+  for (const std::pair<uint32_t, sg_image>& placeholder : placeholders) {
+    if (placeholder.first == color) {
+      return placeholder.second;
+    }
+  }
+
+  sg_image_desc desc = {};
+  desc.width = 1;
+  desc.height = 1;
+  desc.data.subimage[0][0] = { .ptr = &color, .size = sizeof(color) };
+  sg_image image = sg_make_image(desc);
+  placeholders.push_back({ color, image });
+  return image;
+}
+
+uint32_t TextureStreamer::addTexture(const char* fileName, const char* compressedFileName, MipFilter mipFilter, uint32_t placeholderColor, float normalMapScale) {
+  for (uint32_t i = 0; i < textures.size(); i++) {
+    if (textures[i]->fileName == fileName) {
+      return i;
+    }
+  }
+
+  std::unique_ptr<StreamedTexture> texture = std::make_unique<StreamedTexture>();
+  texture->fileName = fileName;
+  texture->compressedFileName = (compressedFileName != nullptr) ? compressedFileName : "";
+  texture->mipFilter = mipFilter;
+  texture->normalMapScale = normalMapScale;
+  texture->placeholder = getPlaceholder(placeholderColor);
+  textures.push_back(std::move(texture));
+  return uint32_t(textures.size() - 1);
+}
+
+void TextureStreamer::request(uint32_t id, uint32_t priority) {
+  StreamedTexture& texture = *textures[id];
+  if (texture.lastRequestFrame != frame) {
+    texture.lastRequestFrame = frame;
+    texture.priority = priority;
+  }
+  else if (priority < texture.priority) {
+    texture.priority = priority;
+  }
+}
+
+sg_image TextureStreamer::getImage(uint32_t id) const {
+  const StreamedTexture& texture = *textures[id];
+  return (texture.state.load() == State::Resident) ? texture.image : texture.placeholder;
+}
+
+void TextureStreamer::loadTexture(StreamedTexture& texture) const {
+  texture.loadFailed = false;
+  if (!texture.compressedFileName.empty() &&
+      load_image(texture.compressedFileName.c_str(), texture.data) &&
+      formatSupported[texture.data.format]) {
+    return;
+  }
+  if (!load_image_cached(texture.fileName.c_str(), "cache", texture.data, true, texture.mipFilter, texture.normalMapScale, jobSystem)) {
+    texture.loadFailed = true;
+  }
+}
+
+void TextureStreamer::evictTexture(StreamedTexture& texture) {
+  sg_destroy_image(texture.image);
+  texture.image = {};
+  residentBytes -= texture.imageBytes;
+  residentCount--;
+  texture.imageBytes = 0;
+  texture.state = State::Unloaded;
+}
+
+void TextureStreamer::update() {
+
+  // Upload completed loads
+  for (std::unique_ptr<StreamedTexture>& texture : textures) {
+    if (texture->state.load() != State::Loaded) {
+      continue;
+    }
+
+    if (!texture->loadFailed) {
+      texture->image = make_image(texture->data);
+      texture->imageBytes = 0;
+      for (int i = 0; i < texture->data.mipCount; i++) {
+        texture->imageBytes += texture->data.levels[i].size;
+      }
+    }
+    free_image_data(texture->data);
+
+    // Failed loads stay resident as the placeholder so they are not retried every frame
+    if (texture->image.id == SG_INVALID_ID) {
+      texture->image = texture->placeholder;
+      texture->imageBytes = 0;
+    }
+    residentBytes += texture->imageBytes;
+    residentCount++;
+    texture->state = State::Resident;
+  }
+
+  // Evict the least recently requested (then furthest) textures until under the budget, never ones needed this frame
+  if (residentBytes > budgetBytes) {
+    candidates.clear();
+    for (uint32_t i = 0; i < textures.size(); i++) {
+      const StreamedTexture& texture = *textures[i];
+      if (texture.state.load() == State::Resident && texture.lastRequestFrame != frame) {
+        candidates.push_back(i);
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+      const StreamedTexture& texA = *textures[a];
+      const StreamedTexture& texB = *textures[b];
+      if (texA.lastRequestFrame != texB.lastRequestFrame) {
+        return texA.lastRequestFrame < texB.lastRequestFrame;
+      }
+      return texA.priority > texB.priority;
+    });
+    for (uint32_t i = 0; i < candidates.size() && residentBytes > budgetBytes; i++) {
+      StreamedTexture& texture = *textures[candidates[i]];
+      if (texture.image.id == texture.placeholder.id) {
+        continue;
+      }
+      evictTexture(texture);
+    }
+  }
+
+  // Start loading the requested textures, highest priority first
+  candidates.clear();
+  for (uint32_t i = 0; i < textures.size(); i++) {
+    const StreamedTexture& texture = *textures[i];
+    if (texture.state.load() == State::Unloaded && texture.lastRequestFrame == frame) {
+      candidates.push_back(i);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+    return textures[a]->priority < textures[b]->priority;
+  });
+  for (uint32_t i = 0; i < candidates.size() && loadsInFlight.load() < maxLoadsInFlight; i++) {
+    StreamedTexture* texture = textures[candidates[i]].get();
+    texture->state = State::Loading;
+    loadsInFlight++;
+    jobSystem->addJob([this, texture]() {
+      loadTexture(*texture);
+      texture->state = State::Loaded;
+      loadsInFlight--;
+    });
+  }
+
+  frame++;
+}
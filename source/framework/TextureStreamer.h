@@ -0,0 +1,90 @@
+#ifndef _TEXTURE_STREAMER_H_
+#define _TEXTURE_STREAMER_H_
+
+#include "Image.h"
+#include "JobSystem.h"
+#include <memory>
+#include <atomic>
+#include <string>
+
+// Loads textures on the job system when they are requested and evicts the least recently requested ones when the
+// resident size goes over the budget. A placeholder image is returned until the texture is resident.
+//
+// Each frame: request() every texture that is (or may soon be) needed, then update() once from the render thread.
+class TextureStreamer
+{
+public:
+
+  TextureStreamer() = default;
+  ~TextureStreamer();
+
+  TextureStreamer(const TextureStreamer&) = delete;
+  TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+  // Must be called after sokol is setup
+  void init(JobSystem* jobSystem, uint64_t budgetBytes, uint32_t maxLoadsInFlight = 4);
+  void shutdown();
+
+  // Register a texture (files are only read once requested). The compressed file is tried first if passed.
+  // A non-zero normal map scale converts the file from a height map. Adding the same file name again returns the existing id.
+  uint32_t addTexture(const char* fileName, const char* compressedFileName, MipFilter mipFilter, uint32_t placeholderColor, float normalMapScale = 0.0f);
+
+  // Mark a texture as needed this frame, lower priority values are loaded first (eg. portal distance)
+  void request(uint32_t id, uint32_t priority);
+
+  // Create the images of completed loads, evict over the budget and start new loads
+  void update();
+
+  sg_image getImage(uint32_t id) const;
+  inline bool isResident(uint32_t id) const { return textures[id]->state.load() == State::Resident; }
+
+  inline uint64_t getResidentBytes() const { return residentBytes; }
+  inline uint32_t getResidentCount() const { return residentCount; }
+  inline uint32_t getTextureCount() const { return uint32_t(textures.size()); }
+
+protected:
+
+  enum class State : uint32_t {
+    Unloaded,
+    Loading,  // Being read on a worker
+    Loaded,   // Data ready to be uploaded
+    Resident,
+  };
+
+  struct StreamedTexture {
+    std::string fileName;
+    std::string compressedFileName;
+    MipFilter mipFilter = MIP_FILTER_LINEAR;
+    float normalMapScale = 0.0f;
+    sg_image placeholder = {};
+
+    std::atomic<State> state = State::Unloaded;
+    ImageData data; // Owned by the worker while loading
+    bool loadFailed = false;
+
+    sg_image image = {};
+    uint64_t imageBytes = 0;
+    uint64_t lastRequestFrame = 0;
+    uint32_t priority = 0;
+  };
+
+  void loadTexture(StreamedTexture& texture) const;
+  void evictTexture(StreamedTexture& texture);
+  sg_image getPlaceholder(uint32_t color);
+
+  JobSystem* jobSystem = nullptr;
+  uint64_t budgetBytes = 0;
+  uint32_t maxLoadsInFlight = 0;
+  bool formatSupported[_SG_PIXELFORMAT_NUM] = {};
+
+  std::vector<std::unique_ptr<StreamedTexture>> textures; // Stable addresses for the load jobs
+  std::vector<std::pair<uint32_t, sg_image>> placeholders;
+  std::vector<uint32_t> candidates;
+
+  uint64_t frame = 1;
+  uint64_t residentBytes = 0;
+  uint32_t residentCount = 0;
+  std::atomic<uint32_t> loadsInFlight = 0;
+};
+
+#endif // _TEXTURE_STREAMER_H_
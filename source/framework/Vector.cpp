@@ -433,37 +433,61 @@ bool findNearestChaserIntersection(const vec3& chaserPosition, const float chase
 
 // HOMOGENEOUS CLIPPING
 //Taken from https://web.archive.org/web/20110528221654/http://wwwx.cs.unc.edu:80/~sud/courses/236/a5/softgl_homoclip_smooth.cpp
+template <CullPlane a_clippingPlane>
+inline bool Inside(const vec4& a_point)
+{
+  if constexpr (a_clippingPlane == CullPlane::Left)   return (a_point.x >= -a_point.w);
+  if constexpr (a_clippingPlane == CullPlane::Right)  return (a_point.x <=  a_point.w);
+  if constexpr (a_clippingPlane == CullPlane::Bottom) return (a_point.y >= -a_point.w);
+  if constexpr (a_clippingPlane == CullPlane::Top)    return (a_point.y <=  a_point.w);
+  if constexpr (a_clippingPlane == CullPlane::Near)   return (a_point.z >= -a_point.w);
+  if constexpr (a_clippingPlane == CullPlane::Far)    return (a_point.z <=  a_point.w);
+  return false;
+}
+
+template <CullPlane a_clippingPlane>
+inline vec4 Intersect(const vec4& v1, const vec4& v2)
+{
+  // Find the parameter of intersection
+  // t = (v1_w-v1_x)/((v2_x - v1_x) - (v2_w - v1_w)) for x=w (RIGHT) plane
+  // ... and similar cases
+  float t = 0.0f;
+  if constexpr (a_clippingPlane == CullPlane::Left)   t = (-v1.w - v1.x) / (v2.x - v1.x + v2.w - v1.w);
+  if constexpr (a_clippingPlane == CullPlane::Right)  t = ( v1.w - v1.x) / (v2.x - v1.x - v2.w + v1.w);
+  if constexpr (a_clippingPlane == CullPlane::Bottom) t = (-v1.w - v1.y) / (v2.y - v1.y + v2.w - v1.w);
+  if constexpr (a_clippingPlane == CullPlane::Top)    t = ( v1.w - v1.y) / (v2.y - v1.y - v2.w + v1.w);
+  if constexpr (a_clippingPlane == CullPlane::Near)   t = (-v1.w - v1.z) / (v2.z - v1.z + v2.w - v1.w);
+  if constexpr (a_clippingPlane == CullPlane::Far)    t = ( v1.w - v1.z) / (v2.z - v1.z - v2.w + v1.w);
+
+  return v1 + ((v2 - v1) * t);
+}
+
 inline bool Inside(const vec4& a_point, CullPlane a_clippingPlane)
 {
   switch (a_clippingPlane)
   {
-  case CullPlane::Left:   return (a_point.x >= -a_point.w);
-  case CullPlane::Right:  return (a_point.x <=  a_point.w);
-  case CullPlane::Bottom: return (a_point.y >= -a_point.w);
-  case CullPlane::Top:    return (a_point.y <=  a_point.w);
-  case CullPlane::Near:   return (a_point.z >= -a_point.w);
-  case CullPlane::Far:    return (a_point.z <=  a_point.w);
+  case CullPlane::Left:   return Inside<CullPlane::Left>(a_point);
+  case CullPlane::Right:  return Inside<CullPlane::Right>(a_point);
+  case CullPlane::Bottom: return Inside<CullPlane::Bottom>(a_point);
+  case CullPlane::Top:    return Inside<CullPlane::Top>(a_point);
+  case CullPlane::Near:   return Inside<CullPlane::Near>(a_point);
+  case CullPlane::Far:    return Inside<CullPlane::Far>(a_point);
   }
   return false;
 }
 
 inline vec4 Intersect(const vec4& v1, const vec4& v2, CullPlane a_clippingPlane)
 {
-  // Find the parameter of intersection
-  // t = (v1_w-v1_x)/((v2_x - v1_x) - (v2_w - v1_w)) for x=w (RIGHT) plane
-  // ... and similar cases
-  float t = 0.0f;
   switch (a_clippingPlane)
   {
-  case CullPlane::Left:   t = (-v1.w - v1.x) / (v2.x - v1.x + v2.w - v1.w); break;
-  case CullPlane::Right:  t = ( v1.w - v1.x) / (v2.x - v1.x - v2.w + v1.w); break;
-  case CullPlane::Bottom: t = (-v1.w - v1.y) / (v2.y - v1.y + v2.w - v1.w); break;
-  case CullPlane::Top:    t = ( v1.w - v1.y) / (v2.y - v1.y - v2.w + v1.w); break;
-  case CullPlane::Near:   t = (-v1.w - v1.z) / (v2.z - v1.z + v2.w - v1.w); break;
-  case CullPlane::Far:    t = ( v1.w - v1.z) / (v2.z - v1.z - v2.w + v1.w); break;
+  case CullPlane::Left:   return Intersect<CullPlane::Left>(v1, v2);
+  case CullPlane::Right:  return Intersect<CullPlane::Right>(v1, v2);
+  case CullPlane::Bottom: return Intersect<CullPlane::Bottom>(v1, v2);
+  case CullPlane::Top:    return Intersect<CullPlane::Top>(v1, v2);
+  case CullPlane::Near:   return Intersect<CullPlane::Near>(v1, v2);
+  case CullPlane::Far:    return Intersect<CullPlane::Far>(v1, v2);
   };
-
-  return v1 + ((v2 - v1) * t);
+  return v1;
 }
 
 
@@ -497,27 +521,49 @@ void clipPolyToPlane(const std::vector<vec4>& a_inArray, std::vector<vec4 >& a_o
   }
 }
 
-// Could do a version that does not allocate by passing in triangles, but would do more culling work
-bool getPolyScreenArea(std::vector<vec4>& a_inoutArray, std::vector<vec4 >& a_workingArray, uint32_t a_screenWidth, uint32_t a_screenHeight, bool a_clipNearFar, uint32_t& o_startX, uint32_t& o_startY, uint32_t& o_width, uint32_t& o_height)
+template <CullPlane a_clippingPlane>
+void clipPolyToPlane(const ClipPoly& a_in, ClipPoly& a_out)
 {
-  o_startX = 0;
-  o_startY = 0;
-  o_width = 0;
-  o_height = 0;    
-    
-  clipPolyToPlane(a_inoutArray, a_workingArray, CullPlane::Left);
-  clipPolyToPlane(a_workingArray, a_inoutArray, CullPlane::Right);
-
-  clipPolyToPlane(a_inoutArray, a_workingArray, CullPlane::Bottom);
-  clipPolyToPlane(a_workingArray, a_inoutArray, CullPlane::Top);
+  a_out.count = 0;
+  if (a_in.count == 0)
+  {
+    return;
+  }
 
-  if (a_clipNearFar)
+  // Points are always written, but the count only advances if the point is kept.
+  // The intersection is calculated even when discarded (may be inf/nan) to avoid branching.
+  uint32_t outCount = 0;
+  const vec4* LastPt = &a_in.points[a_in.count - 1];
+  bool bLastIn = Inside<a_clippingPlane>(*LastPt);
+  for (uint32_t i = 0; i < a_in.count; i++)
   {
-    clipPolyToPlane(a_inoutArray, a_workingArray, CullPlane::Near);
-    clipPolyToPlane(a_workingArray, a_inoutArray, CullPlane::Far);
+    const vec4* Pt = &a_in.points[i];
+    bool bIn = Inside<a_clippingPlane>(*Pt);
+
+    a_out.points[outCount] = Intersect<a_clippingPlane>(*LastPt, *Pt);
+    outCount += uint32_t(bIn != bLastIn);
+    outCount = (outCount < CLIP_POLY_MAX_POINTS) ? outCount : CLIP_POLY_MAX_POINTS;
+
+    a_out.points[outCount] = *Pt;
+    outCount += uint32_t(bIn);
+    outCount = (outCount < CLIP_POLY_MAX_POINTS) ? outCount : CLIP_POLY_MAX_POINTS;
+
+    LastPt = Pt;
+    bLastIn = bIn;
   }
+  a_out.count = outCount;
+}
 
-  if (a_inoutArray.size() == 0)
+template void clipPolyToPlane<CullPlane::Left>(const ClipPoly& a_in, ClipPoly& a_out);
+template void clipPolyToPlane<CullPlane::Right>(const ClipPoly& a_in, ClipPoly& a_out);
+template void clipPolyToPlane<CullPlane::Bottom>(const ClipPoly& a_in, ClipPoly& a_out);
+template void clipPolyToPlane<CullPlane::Top>(const ClipPoly& a_in, ClipPoly& a_out);
+template void clipPolyToPlane<CullPlane::Near>(const ClipPoly& a_in, ClipPoly& a_out);
+template void clipPolyToPlane<CullPlane::Far>(const ClipPoly& a_in, ClipPoly& a_out);
+
+static bool getScreenArea(const vec4* a_points, uint32_t a_pointCount, uint32_t a_screenWidth, uint32_t a_screenHeight, uint32_t& o_startX, uint32_t& o_startY, uint32_t& o_width, uint32_t& o_height)
+{
+  if (a_pointCount == 0)
   {
     return false;
   }
@@ -527,8 +573,10 @@ bool getPolyScreenArea(std::vector<vec4>& a_inoutArray, std::vector<vec4 >& a_wo
   float maxX = -FLT_MAX;
   float minY = FLT_MAX;
   float maxY = -FLT_MAX;
-  for (const vec4& inPoint : a_inoutArray)
+  for (uint32_t i = 0; i < a_pointCount; i++)
   {
+    const vec4& inPoint = a_points[i];
+
     // This divide check enables the point positions to OKish when not doing the clip to plane code above.
     // Leaving here just to be sure.
     float Div = inPoint.w;
@@ -578,6 +626,212 @@ bool getPolyScreenArea(std::vector<vec4>& a_inoutArray, std::vector<vec4 >& a_wo
   return true;
 }
 
+// Could do a version that does not allocate by passing in triangles, but would do more culling work
+bool getPolyScreenArea(std::vector<vec4>& a_inoutArray, std::vector<vec4 >& a_workingArray, uint32_t a_screenWidth, uint32_t a_screenHeight, bool a_clipNearFar, uint32_t& o_startX, uint32_t& o_startY, uint32_t& o_width, uint32_t& o_height)
+{
+  o_startX = 0;
+  o_startY = 0;
+  o_width = 0;
+  o_height = 0;    
+    
+  clipPolyToPlane(a_inoutArray, a_workingArray, CullPlane::Left);
+  clipPolyToPlane(a_workingArray, a_inoutArray, CullPlane::Right);
+
+  clipPolyToPlane(a_inoutArray, a_workingArray, CullPlane::Bottom);
+  clipPolyToPlane(a_workingArray, a_inoutArray, CullPlane::Top);
+
+  if (a_clipNearFar)
+  {
+    clipPolyToPlane(a_inoutArray, a_workingArray, CullPlane::Near);
+    clipPolyToPlane(a_workingArray, a_inoutArray, CullPlane::Far);
+  }
+
+  return getScreenArea(a_inoutArray.data(), (uint32_t)a_inoutArray.size(), a_screenWidth, a_screenHeight, o_startX, o_startY, o_width, o_height);
+}
+
+bool getPolyScreenArea(ClipPoly& a_inoutPoly, uint32_t a_screenWidth, uint32_t a_screenHeight, bool a_clipNearFar, uint32_t& o_startX, uint32_t& o_startY, uint32_t& o_width, uint32_t& o_height)
+{
+  o_startX = 0;
+  o_startY = 0;
+  o_width = 0;
+  o_height = 0;
+
+  ClipPoly workingPoly;
+  clipPolyToPlane<CullPlane::Left>(a_inoutPoly, workingPoly);
+  clipPolyToPlane<CullPlane::Right>(workingPoly, a_inoutPoly);
+
+  clipPolyToPlane<CullPlane::Bottom>(a_inoutPoly, workingPoly);
+  clipPolyToPlane<CullPlane::Top>(workingPoly, a_inoutPoly);
+
+  if (a_clipNearFar)
+  {
+    clipPolyToPlane<CullPlane::Near>(a_inoutPoly, workingPoly);
+    clipPolyToPlane<CullPlane::Far>(workingPoly, a_inoutPoly);
+  }
+
+  return getScreenArea(a_inoutPoly.points, a_inoutPoly.count, a_screenWidth, a_screenHeight, o_startX, o_startY, o_width, o_height);
+}
+
+bool getBoxScreenArea(const mat4& a_mvp, const vec3& a_boxCenter, const vec3& a_boxExtents, uint32_t a_screenWidth, uint32_t a_screenHeight, uint32_t& o_startX, uint32_t& o_startY, uint32_t& o_width, uint32_t& o_height)
+{
+  o_startX = 0;
+  o_startY = 0;
+  o_width = 0;
+  o_height = 0;
+
+  // Transform the corners as two quads (the bottom and top faces)
+  vec3 boxMin = a_boxCenter - a_boxExtents;
+  vec3 boxMax = a_boxCenter + a_boxExtents;
+  vec4 quadX[2] = { vec4(boxMin.x, boxMax.x, boxMax.x, boxMin.x), vec4(boxMin.x, boxMax.x, boxMax.x, boxMin.x) };
+  vec4 quadY[2] = { vec4(boxMin.y), vec4(boxMax.y) };
+  vec4 quadZ[2] = { vec4(boxMin.z, boxMin.z, boxMax.z, boxMax.z), vec4(boxMin.z, boxMin.z, boxMax.z, boxMax.z) };
+
+  vec4 clipPoints[8];
+  uint32_t outcodes[2];
+  transformQuadsToClipSpace(a_mvp, quadX, quadY, quadZ, 2, clipPoints, outcodes);
+  if ((outcodes[0] & outcodes[1]) != 0)
+  {
+    return false;
+  }
+
+  // Corners behind the camera do not project to the screen, so use all of it
+  for (uint32_t i = 0; i < 8; i++)
+  {
+    if (clipPoints[i].w <= 0.0f)
+    {
+      o_width = a_screenWidth;
+      o_height = a_screenHeight;
+      return true;
+    }
+  }
+
+  return getScreenArea(clipPoints, 8, a_screenWidth, a_screenHeight, o_startX, o_startY, o_width, o_height);
+}
+
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+// Get the plane outcode bits from the 4 corners of a quad
+static inline uint32_t getQuadOutcodeSSE(__m128 a_x, __m128 a_y, __m128 a_z, __m128 a_w)
+{
+  __m128 negW = _mm_sub_ps(_mm_setzero_ps(), a_w);
+  uint32_t outcode = 0;
+  outcode |= uint32_t(_mm_movemask_ps(_mm_cmplt_ps(a_x, negW)) == 0xF) << uint32_t(CullPlane::Left);
+  outcode |= uint32_t(_mm_movemask_ps(_mm_cmpgt_ps(a_x, a_w))  == 0xF) << uint32_t(CullPlane::Right);
+  outcode |= uint32_t(_mm_movemask_ps(_mm_cmplt_ps(a_y, negW)) == 0xF) << uint32_t(CullPlane::Bottom);
+  outcode |= uint32_t(_mm_movemask_ps(_mm_cmpgt_ps(a_y, a_w))  == 0xF) << uint32_t(CullPlane::Top);
+  outcode |= uint32_t(_mm_movemask_ps(_mm_cmplt_ps(a_z, negW)) == 0xF) << uint32_t(CullPlane::Near);
+  outcode |= uint32_t(_mm_movemask_ps(_mm_cmpgt_ps(a_z, a_w))  == 0xF) << uint32_t(CullPlane::Far);
+  return outcode;
+}
+
+// Write the 4 corners of a quad (structure of arrays) out as clip space points 
+static inline void storeQuadPointsSSE(__m128 a_x, __m128 a_y, __m128 a_z, __m128 a_w, vec4* o_clipPoints)
+{
+  _MM_TRANSPOSE4_PS(a_x, a_y, a_z, a_w);
+  _mm_storeu_ps(&o_clipPoints[0].x, a_x);
+  _mm_storeu_ps(&o_clipPoints[1].x, a_y);
+  _mm_storeu_ps(&o_clipPoints[2].x, a_z);
+  _mm_storeu_ps(&o_clipPoints[3].x, a_w);
+}
+
+#endif // GLM_ARCH_SSE2_BIT
+
+void transformQuadsToClipSpace(const mat4& a_mvp, const vec4* a_quadX, const vec4* a_quadY, const vec4* a_quadZ, uint32_t a_quadCount, vec4* o_clipPoints, uint32_t* o_outcodes)
+{
+  uint32_t q = 0;
+
+#if GLM_ARCH & GLM_ARCH_AVX_BIT
+  // Process 2 quads (8 corners) per iteration
+  {
+    __m256 m[4][4];
+    for (uint32_t c = 0; c < 4; c++)
+    {
+      for (uint32_t r = 0; r < 4; r++)
+      {
+        m[c][r] = _mm256_set1_ps(a_mvp[c][r]);
+      }
+    }
+
+    for (; q + 2 <= a_quadCount; q += 2)
+    {
+      __m256 x = _mm256_loadu_ps(&a_quadX[q].x);
+      __m256 y = _mm256_loadu_ps(&a_quadY[q].x);
+      __m256 z = _mm256_loadu_ps(&a_quadZ[q].x);
+
+      __m256 clip[4];
+      for (uint32_t r = 0; r < 4; r++)
+      {
+        clip[r] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[0][r], x), _mm256_mul_ps(m[1][r], y)),
+                                _mm256_add_ps(_mm256_mul_ps(m[2][r], z), m[3][r]));
+      }
+
+      for (uint32_t h = 0; h < 2; h++)
+      {
+        __m128 cx = (h == 0) ? _mm256_castps256_ps128(clip[0]) : _mm256_extractf128_ps(clip[0], 1);
+        __m128 cy = (h == 0) ? _mm256_castps256_ps128(clip[1]) : _mm256_extractf128_ps(clip[1], 1);
+        __m128 cz = (h == 0) ? _mm256_castps256_ps128(clip[2]) : _mm256_extractf128_ps(clip[2], 1);
+        __m128 cw = (h == 0) ? _mm256_castps256_ps128(clip[3]) : _mm256_extractf128_ps(clip[3], 1);
+
+        o_outcodes[q + h] = getQuadOutcodeSSE(cx, cy, cz, cw);
+        storeQuadPointsSSE(cx, cy, cz, cw, &o_clipPoints[(q + h) * 4]);
+      }
+    }
+  }
+#endif // GLM_ARCH_AVX_BIT
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+  {
+    __m128 m[4][4];
+    for (uint32_t c = 0; c < 4; c++)
+    {
+      for (uint32_t r = 0; r < 4; r++)
+      {
+        m[c][r] = _mm_set1_ps(a_mvp[c][r]);
+      }
+    }
+
+    for (; q < a_quadCount; q++)
+    {
+      __m128 x = _mm_loadu_ps(&a_quadX[q].x);
+      __m128 y = _mm_loadu_ps(&a_quadY[q].x);
+      __m128 z = _mm_loadu_ps(&a_quadZ[q].x);
+
+      __m128 clip[4];
+      for (uint32_t r = 0; r < 4; r++)
+      {
+        clip[r] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0][r], x), _mm_mul_ps(m[1][r], y)),
+                             _mm_add_ps(_mm_mul_ps(m[2][r], z), m[3][r]));
+      }
+
+      o_outcodes[q] = getQuadOutcodeSSE(clip[0], clip[1], clip[2], clip[3]);
+      storeQuadPointsSSE(clip[0], clip[1], clip[2], clip[3], &o_clipPoints[q * 4]);
+    }
+  }
+#endif // GLM_ARCH_SSE2_BIT
+
+  // Scalar fallback
+  for (; q < a_quadCount; q++)
+  {
+    uint32_t outcode = 0x3F;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+      vec4 point = a_mvp * vec4(a_quadX[q][i], a_quadY[q][i], a_quadZ[q][i], 1.0f);
+      o_clipPoints[q * 4 + i] = point;
+
+      uint32_t pointOutcode = 0;
+      pointOutcode |= uint32_t(point.x < -point.w) << uint32_t(CullPlane::Left);
+      pointOutcode |= uint32_t(point.x >  point.w) << uint32_t(CullPlane::Right);
+      pointOutcode |= uint32_t(point.y < -point.w) << uint32_t(CullPlane::Bottom);
+      pointOutcode |= uint32_t(point.y >  point.w) << uint32_t(CullPlane::Top);
+      pointOutcode |= uint32_t(point.z < -point.w) << uint32_t(CullPlane::Near);
+      pointOutcode |= uint32_t(point.z >  point.w) << uint32_t(CullPlane::Far);
+      outcode &= pointOutcode;
+    }
+    o_outcodes[q] = outcode;
+  }
+}
+
 
 void applyScissorProjection(mat4& a_projection, uint32_t a_screenWidth, uint32_t a_screenHeight, uint32_t a_startX, uint32_t a_startY, uint32_t a_width, uint32_t a_height)
 {
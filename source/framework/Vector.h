@@ -73,6 +73,17 @@ enum class CullPlane
 	Far
 };
 
+// Fixed capacity polygon for homogeneous clipping without allocations.
+// A quad clipped against all six clip planes never exceeds 10 points.
+// NOTE: One extra point is reserved as a scratch location for branchless appends
+const uint32_t CLIP_POLY_MAX_POINTS = 10;
+
+struct ClipPoly
+{
+	vec4 points[CLIP_POLY_MAX_POINTS + 1];
+	uint32_t count = 0;
+};
+
 struct half {
 	unsigned short sh;
 
@@ -112,9 +123,24 @@ bool findNearestChaserIntersection(const vec3& chaserPosition, const float chase
 // Clip a polygon in Homogeneous coordinates agains a clipping plane 
 void clipPolyToPlane(const std::vector<vec4>& a_inArray, std::vector<vec4 >& a_outArray, CullPlane a_clippingPlane);
 
+// Clip a fixed capacity polygon in Homogeneous coordinates against a clipping plane (plane resolved at compile time)
+template <CullPlane a_clippingPlane>
+void clipPolyToPlane(const ClipPoly& a_in, ClipPoly& a_out);
+
+// Transform quads stored as a structure of arrays (the 4 corner x, y and z values of each quad in a vec4) into clip space.
+// Returns 4 clip space points per quad and an outcode per quad with a bit (1 << CullPlane) set for each clip plane 
+// that all 4 corners are outside of (a non-zero outcode means the quad can be culled)
+void transformQuadsToClipSpace(const mat4& a_mvp, const vec4* a_quadX, const vec4* a_quadY, const vec4* a_quadZ, uint32_t a_quadCount, vec4* o_clipPoints, uint32_t* o_outcodes);
+
 // Get the screen area of a polygon in Homogeneous coordinates (also returns the clipped polygon in source array)
 bool getPolyScreenArea(std::vector<vec4>& a_inoutArray, std::vector<vec4 >& a_workingArray, uint32_t a_screenWidth, uint32_t a_screenHeight, bool a_clipNearFar, uint32_t &o_startX, uint32_t& o_startY, uint32_t& o_width, uint32_t& o_height);
 
+// Get the screen area of a fixed capacity polygon in Homogeneous coordinates (does not allocate, also returns the clipped polygon)
+bool getPolyScreenArea(ClipPoly& a_inoutPoly, uint32_t a_screenWidth, uint32_t a_screenHeight, bool a_clipNearFar, uint32_t& o_startX, uint32_t& o_startY, uint32_t& o_width, uint32_t& o_height);
+
+// Get the screen area of an AABB (the whole screen if the box crosses the camera plane). Returns false if the box is outside the view frustum.
+bool getBoxScreenArea(const mat4& a_mvp, const vec3& a_boxCenter, const vec3& a_boxExtents, uint32_t a_screenWidth, uint32_t a_screenHeight, uint32_t& o_startX, uint32_t& o_startY, uint32_t& o_width, uint32_t& o_height);
+
 // Calculate an adjusted projection matrix to mimic a scissor area
 void applyScissorProjection(mat4& a_projection, uint32_t a_screenWidth, uint32_t a_screenHeight, uint32_t a_startX, uint32_t a_startY, uint32_t a_width, uint32_t a_height);
 
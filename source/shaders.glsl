@@ -109,3 +109,115 @@ void main() {
 @end
 
 @program shd_pfx vs_pfx fs_pfx
+
+@vs vs_pfx_inst
+uniform vs_params_pfx_inst {
+    mat4 mvp;
+    vec4 dx;
+    vec4 dy;
+};
+
+in vec2 corner;
+in vec4 inst_pos_size;
+in vec4 inst_color;
+out vec2 uv;
+out vec4 color;
+
+void main() {
+  // Expand the billboard corner around the particle position
+  vec3 pos = inst_pos_size.xyz + (dx.xyz * corner.x + dy.xyz * corner.y) * inst_pos_size.w;
+  gl_Position = mvp * vec4(pos, 1.0);
+
+  uv = vec2(0.5) + vec2(0.5, -0.5) * corner;
+  color = inst_color;
+}
+@end
+
+@program shd_pfx_inst vs_pfx_inst fs_pfx
+
+@vs vs_lights
+out vec2 texCoord;
+out vec3 worldPos;
+out vec3 viewVec;
+out vec3 tangent0;
+out vec3 tangent1;
+out vec3 tangent2;
+
+uniform vs_params_lights {
+    mat4 mvp;
+    vec4 camPos;
+};
+
+in vec4 position;
+in vec2 uv;
+in vec3 mat0;
+in vec3 mat1;
+in vec3 mat2x;
+
+void main() {
+
+  gl_Position = mvp * position;
+
+  texCoord = uv.xy;
+  worldPos = position.xyz;
+
+  tangent0 = mat0;
+  tangent1 = mat1;
+  tangent2 = mat2x;
+
+  vec3 vVec = camPos.xyz - position.xyz;
+  viewVec.x = dot(mat0.xyz, vVec);
+  viewVec.y = dot(mat1.xyz, vVec);
+  viewVec.z = dot(mat2x.xyz, vVec);
+}
+@end
+
+@fs fs_lights
+uniform texture2D Base;
+uniform texture2D Bump;
+uniform sampler smp;
+
+uniform fs_params_lights {
+  vec4 lights[8]; // Position and inverse radius
+  float ambient;
+  float lightCount;
+};
+
+in vec2 texCoord;
+in vec3 worldPos;
+in vec3 viewVec;
+in vec3 tangent0;
+in vec3 tangent1;
+in vec3 tangent2;
+
+out vec4 frag_color;
+
+void main(){
+
+	vec4 base = texture(sampler2D(Base,smp), texCoord);
+	vec3 bump = texture(sampler2D(Bump,smp), texCoord).xyz * 2.0 - 1.0;
+
+	bump = normalize(bump);
+	vec3 reflected = reflect(normalize(-viewVec), bump);
+
+	vec4 color = ambient * base;
+	int count = int(lightCount);
+	for (int i = 0; i < count; i++){
+		vec3 wVec = lights[i].xyz - worldPos;
+		vec3 lightVec = vec3(dot(tangent0, wVec), dot(tangent1, wVec), dot(tangent2, wVec));
+
+		float distSqr = dot(lightVec, lightVec);
+		vec3 lVec = lightVec * inversesqrt(distSqr);
+
+		float atten = clamp(1.0 - lights[i].w * sqrt(distSqr), 0.0, 1.0);
+		float diffuse = clamp(dot(lVec, bump), 0.0, 1.0);
+
+		float specular = pow(clamp(dot(reflected, lVec), 0.0, 1.0), 16.0);
+
+		color += (diffuse * base + 0.6 * specular) * atten;
+	}
+	frag_color = color;
+}
+@end
+
+@program shd_lights vs_lights fs_lights
@@ -6,6 +6,10 @@
 
     Cmdline: sokol-shdc --input shaders.glsl --output shaders.h --slang glsl330:hlsl5 --ifdef
 
+    NOTE: the 'pfx_inst' and 'lights' programs were written by hand in the sokol-shdc output layout (the tool was not
+    available), each embedded source array matches the comment above it. Regenerate this file with the command
+    line above to replace them with the real sokol-shdc output.
+
     Overview:
 
         Shader program 'shd':
@@ -64,11 +68,69 @@
                     Image: tex0
                     Sampler: smp
 
+        Shader program 'shd_pfx_inst':
+            Get shader desc: shd_pfx_inst_shader_desc(sg_query_backend());
+            Vertex shader: vs_pfx_inst
+                Attribute slots:
+                    ATTR_vs_pfx_inst_corner = 0
+                    ATTR_vs_pfx_inst_inst_pos_size = 1
+                    ATTR_vs_pfx_inst_inst_color = 2
+                Uniform block 'vs_params_pfx_inst':
+                    C struct: vs_params_pfx_inst_t
+                    Bind slot: SLOT_vs_params_pfx_inst = 0
+            Fragment shader: fs_pfx
+                Image 'tex0':
+                    Type: SG_IMAGETYPE_2D
+                    Sample Type: SG_IMAGESAMPLETYPE_FLOAT
+                    Bind slot: SLOT_tex0 = 0
+                Sampler 'smp':
+                    Type: SG_SAMPLERTYPE_FILTERING
+                    Bind slot: SLOT_smp = 0
+                Image Sampler Pair 'tex0_smp':
+                    Image: tex0
+                    Sampler: smp
+
+        Shader program 'shd_lights':
+            Get shader desc: shd_lights_shader_desc(sg_query_backend());
+            Vertex shader: vs_lights
+                Attribute slots:
+                    ATTR_vs_lights_position = 0
+                    ATTR_vs_lights_uv = 1
+                    ATTR_vs_lights_mat0 = 2
+                    ATTR_vs_lights_mat1 = 3
+                    ATTR_vs_lights_mat2x = 4
+                Uniform block 'vs_params_lights':
+                    C struct: vs_params_lights_t
+                    Bind slot: SLOT_vs_params_lights = 0
+            Fragment shader: fs_lights
+                Uniform block 'fs_params_lights':
+                    C struct: fs_params_lights_t
+                    Bind slot: SLOT_fs_params_lights = 0
+                Image 'Base':
+                    Type: SG_IMAGETYPE_2D
+                    Sample Type: SG_IMAGESAMPLETYPE_FLOAT
+                    Bind slot: SLOT_Base = 0
+                Image 'Bump':
+                    Type: SG_IMAGETYPE_2D
+                    Sample Type: SG_IMAGESAMPLETYPE_FLOAT
+                    Bind slot: SLOT_Bump = 1
+                Sampler 'smp':
+                    Type: SG_SAMPLERTYPE_FILTERING
+                    Bind slot: SLOT_smp = 0
+                Image Sampler Pair 'Base_smp':
+                    Image: Base
+                    Sampler: smp
+                Image Sampler Pair 'Bump_smp':
+                    Image: Bump
+                    Sampler: smp
+
 
     Shader descriptor structs:
 
         sg_shader shd = sg_make_shader(shd_shader_desc(sg_query_backend()));
         sg_shader shd_pfx = sg_make_shader(shd_pfx_shader_desc(sg_query_backend()));
+        sg_shader shd_pfx_inst = sg_make_shader(shd_pfx_inst_shader_desc(sg_query_backend()));
+        sg_shader shd_lights = sg_make_shader(shd_lights_shader_desc(sg_query_backend()));
 
     Vertex attribute locations for vertex shader 'vs':
 
@@ -96,6 +158,32 @@
             },
             ...});
 
+    Vertex attribute locations for vertex shader 'vs_pfx_inst':
+
+        sg_pipeline pip = sg_make_pipeline(&(sg_pipeline_desc){
+            .layout = {
+                .attrs = {
+                    [ATTR_vs_pfx_inst_corner] = { ... },
+                    [ATTR_vs_pfx_inst_inst_pos_size] = { ... },
+                    [ATTR_vs_pfx_inst_inst_color] = { ... },
+                },
+            },
+            ...});
+
+    Vertex attribute locations for vertex shader 'vs_lights':
+
+        sg_pipeline pip = sg_make_pipeline(&(sg_pipeline_desc){
+            .layout = {
+                .attrs = {
+                    [ATTR_vs_lights_position] = { ... },
+                    [ATTR_vs_lights_uv] = { ... },
+                    [ATTR_vs_lights_mat0] = { ... },
+                    [ATTR_vs_lights_mat1] = { ... },
+                    [ATTR_vs_lights_mat2x] = { ... },
+                },
+            },
+            ...});
+
 
     Image bind slots, use as index in sg_bindings.vs.images[] or .fs.images[]
 
@@ -131,6 +219,32 @@
         };
         sg_apply_uniforms(SG_SHADERSTAGE_[VS|FS], SLOT_vs_params_pfx, &SG_RANGE(vs_params_pfx));
 
+    Bind slot and C-struct for uniform block 'vs_params_pfx_inst':
+
+        vs_params_pfx_inst_t vs_params_pfx_inst = {
+            .mvp = ...;
+            .dx = ...;
+            .dy = ...;
+        };
+        sg_apply_uniforms(SG_SHADERSTAGE_[VS|FS], SLOT_vs_params_pfx_inst, &SG_RANGE(vs_params_pfx_inst));
+
+    Bind slot and C-struct for uniform block 'vs_params_lights':
+
+        vs_params_lights_t vs_params_lights = {
+            .mvp = ...;
+            .camPos = ...;
+        };
+        sg_apply_uniforms(SG_SHADERSTAGE_[VS|FS], SLOT_vs_params_lights, &SG_RANGE(vs_params_lights));
+
+    Bind slot and C-struct for uniform block 'fs_params_lights':
+
+        fs_params_lights_t fs_params_lights = {
+            .lights = ...;
+            .ambient = ...;
+            .lightCount = ...;
+        };
+        sg_apply_uniforms(SG_SHADERSTAGE_[VS|FS], SLOT_fs_params_lights, &SG_RANGE(fs_params_lights));
+
 */
 #include <stdint.h>
 #include <stdbool.h>
@@ -151,6 +265,14 @@
 #define ATTR_vs_pfx_position (0)
 #define ATTR_vs_pfx_in_uv (1)
 #define ATTR_vs_pfx_in_color (2)
+#define ATTR_vs_pfx_inst_corner (0)
+#define ATTR_vs_pfx_inst_inst_pos_size (1)
+#define ATTR_vs_pfx_inst_inst_color (2)
+#define ATTR_vs_lights_position (0)
+#define ATTR_vs_lights_uv (1)
+#define ATTR_vs_lights_mat0 (2)
+#define ATTR_vs_lights_mat1 (3)
+#define ATTR_vs_lights_mat2x (4)
 #define SLOT_Base (0)
 #define SLOT_Bump (1)
 #define SLOT_tex0 (0)
@@ -179,6 +301,30 @@ SOKOL_SHDC_ALIGN(16) typedef struct vs_params_pfx_t {
     mat4 mvp;
 } vs_params_pfx_t;
 #pragma pack(pop)
+#define SLOT_vs_params_pfx_inst (0)
+#pragma pack(push,1)
+SOKOL_SHDC_ALIGN(16) typedef struct vs_params_pfx_inst_t {
+    mat4 mvp;
+    vec4 dx;
+    vec4 dy;
+} vs_params_pfx_inst_t;
+#pragma pack(pop)
+#define SLOT_vs_params_lights (0)
+#pragma pack(push,1)
+SOKOL_SHDC_ALIGN(16) typedef struct vs_params_lights_t {
+    mat4 mvp;
+    vec4 camPos;
+} vs_params_lights_t;
+#pragma pack(pop)
+#define SLOT_fs_params_lights (0)
+#pragma pack(push,1)
+SOKOL_SHDC_ALIGN(16) typedef struct fs_params_lights_t {
+    vec4 lights[8];
+    float ambient;
+    float lightCount;
+    uint8_t _pad_136[8];
+} fs_params_lights_t;
+#pragma pack(pop)
 #if defined(SOKOL_GLCORE33)
 /*
     #version 330
@@ -394,6 +540,241 @@ static const char fs_pfx_source_glsl330[196] = {
     0x63,0x6f,0x6c,0x6f,0x72,0x20,0x2a,0x3d,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,
     0x7d,0x0a,0x0a,0x00,
 };
+/*
+    #version 330
+    
+    uniform vec4 vs_params_pfx_inst[6];
+    layout(location = 1) in vec4 inst_pos_size;
+    layout(location = 0) in vec2 corner;
+    out vec2 uv;
+    out vec4 color;
+    layout(location = 2) in vec4 inst_color;
+    
+    void main()
+    {
+        gl_Position = mat4(vs_params_pfx_inst[0], vs_params_pfx_inst[1], vs_params_pfx_inst[2], vs_params_pfx_inst[3]) * vec4(inst_pos_size.xyz + ((vs_params_pfx_inst[4].xyz * corner.x) + (vs_params_pfx_inst[5].xyz * corner.y)) * inst_pos_size.w, 1.0);
+        uv = vec2(0.5) + (vec2(0.5, -0.5) * corner);
+        color = inst_color;
+    }
+    
+*/
+static const char vs_pfx_inst_source_glsl330[542] = {
+    0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x33,0x30,0x0a,0x0a,0x75,0x6e,
+    0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x73,0x5f,0x70,0x61,
+    0x72,0x61,0x6d,0x73,0x5f,0x70,0x66,0x78,0x5f,0x69,0x6e,0x73,0x74,0x5b,0x36,0x5d,
+    0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,
+    0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x69,
+    0x6e,0x73,0x74,0x5f,0x70,0x6f,0x73,0x5f,0x73,0x69,0x7a,0x65,0x3b,0x0a,0x6c,0x61,
+    0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,
+    0x30,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x63,0x6f,0x72,0x6e,0x65,
+    0x72,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,
+    0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x34,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,
+    0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,
+    0x3d,0x20,0x32,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x69,0x6e,0x73,
+    0x74,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,
+    0x61,0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,
+    0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x6d,0x61,0x74,0x34,0x28,0x76,
+    0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x70,0x66,0x78,0x5f,0x69,0x6e,0x73,
+    0x74,0x5b,0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,
+    0x70,0x66,0x78,0x5f,0x69,0x6e,0x73,0x74,0x5b,0x31,0x5d,0x2c,0x20,0x76,0x73,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x70,0x66,0x78,0x5f,0x69,0x6e,0x73,0x74,0x5b,
+    0x32,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x70,0x66,
+    0x78,0x5f,0x69,0x6e,0x73,0x74,0x5b,0x33,0x5d,0x29,0x20,0x2a,0x20,0x76,0x65,0x63,
+    0x34,0x28,0x69,0x6e,0x73,0x74,0x5f,0x70,0x6f,0x73,0x5f,0x73,0x69,0x7a,0x65,0x2e,
+    0x78,0x79,0x7a,0x20,0x2b,0x20,0x28,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,
+    0x73,0x5f,0x70,0x66,0x78,0x5f,0x69,0x6e,0x73,0x74,0x5b,0x34,0x5d,0x2e,0x78,0x79,
+    0x7a,0x20,0x2a,0x20,0x63,0x6f,0x72,0x6e,0x65,0x72,0x2e,0x78,0x29,0x20,0x2b,0x20,
+    0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x70,0x66,0x78,0x5f,0x69,
+    0x6e,0x73,0x74,0x5b,0x35,0x5d,0x2e,0x78,0x79,0x7a,0x20,0x2a,0x20,0x63,0x6f,0x72,
+    0x6e,0x65,0x72,0x2e,0x79,0x29,0x29,0x20,0x2a,0x20,0x69,0x6e,0x73,0x74,0x5f,0x70,
+    0x6f,0x73,0x5f,0x73,0x69,0x7a,0x65,0x2e,0x77,0x2c,0x20,0x31,0x2e,0x30,0x29,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x75,0x76,0x20,0x3d,0x20,0x76,0x65,0x63,0x32,0x28,0x30,
+    0x2e,0x35,0x29,0x20,0x2b,0x20,0x28,0x76,0x65,0x63,0x32,0x28,0x30,0x2e,0x35,0x2c,
+    0x20,0x2d,0x30,0x2e,0x35,0x29,0x20,0x2a,0x20,0x63,0x6f,0x72,0x6e,0x65,0x72,0x29,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x69,0x6e,
+    0x73,0x74,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
+};
+/*
+    #version 330
+    
+    uniform vec4 vs_params_lights[5];
+    layout(location = 0) in vec4 position;
+    out vec2 texCoord;
+    layout(location = 1) in vec2 uv;
+    out vec3 worldPos;
+    out vec3 tangent0;
+    layout(location = 2) in vec3 mat0;
+    out vec3 tangent1;
+    layout(location = 3) in vec3 mat1;
+    out vec3 tangent2;
+    layout(location = 4) in vec3 mat2x;
+    out vec3 viewVec;
+    
+    void main()
+    {
+        gl_Position = mat4(vs_params_lights[0], vs_params_lights[1], vs_params_lights[2], vs_params_lights[3]) * position;
+        texCoord = uv;
+        worldPos = position.xyz;
+        tangent0 = mat0;
+        tangent1 = mat1;
+        tangent2 = mat2x;
+        vec3 _62 = vs_params_lights[4].xyz - position.xyz;
+        viewVec.x = dot(mat0, _62);
+        viewVec.y = dot(mat1, _62);
+        viewVec.z = dot(mat2x, _62);
+    }
+    
+*/
+static const char vs_lights_source_glsl330[741] = {
+    0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x33,0x30,0x0a,0x0a,0x75,0x6e,
+    0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x73,0x5f,0x70,0x61,
+    0x72,0x61,0x6d,0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x5b,0x35,0x5d,0x3b,0x0a,
+    0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,
+    0x3d,0x20,0x30,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x70,0x6f,0x73,
+    0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x32,0x20,
+    0x74,0x65,0x78,0x43,0x6f,0x6f,0x72,0x64,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,
+    0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,0x69,
+    0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,
+    0x65,0x63,0x33,0x20,0x77,0x6f,0x72,0x6c,0x64,0x50,0x6f,0x73,0x3b,0x0a,0x6f,0x75,
+    0x74,0x20,0x76,0x65,0x63,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x30,0x3b,
+    0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,
+    0x20,0x3d,0x20,0x32,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x33,0x20,0x6d,0x61,
+    0x74,0x30,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x33,0x20,0x74,0x61,0x6e,
+    0x67,0x65,0x6e,0x74,0x31,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,
+    0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x33,0x29,0x20,0x69,0x6e,0x20,0x76,
+    0x65,0x63,0x33,0x20,0x6d,0x61,0x74,0x31,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,
+    0x63,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,0x3b,0x0a,0x6c,0x61,0x79,
+    0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x34,
+    0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x33,0x20,0x6d,0x61,0x74,0x32,0x78,0x3b,
+    0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x33,0x20,0x76,0x69,0x65,0x77,0x56,0x65,
+    0x63,0x3b,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,0x28,0x29,0x0a,
+    0x7b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,
+    0x6e,0x20,0x3d,0x20,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,
+    0x6d,0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x5b,0x30,0x5d,0x2c,0x20,0x76,0x73,
+    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x5b,0x31,
+    0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x6c,0x69,0x67,
+    0x68,0x74,0x73,0x5b,0x32,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,
+    0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x5b,0x33,0x5d,0x29,0x20,0x2a,0x20,0x70,
+    0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x20,0x20,0x20,0x20,0x74,0x65,0x78,
+    0x43,0x6f,0x6f,0x72,0x64,0x20,0x3d,0x20,0x75,0x76,0x3b,0x0a,0x20,0x20,0x20,0x20,
+    0x77,0x6f,0x72,0x6c,0x64,0x50,0x6f,0x73,0x20,0x3d,0x20,0x70,0x6f,0x73,0x69,0x74,
+    0x69,0x6f,0x6e,0x2e,0x78,0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x74,0x61,0x6e,
+    0x67,0x65,0x6e,0x74,0x30,0x20,0x3d,0x20,0x6d,0x61,0x74,0x30,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x31,0x20,0x3d,0x20,0x6d,0x61,0x74,
+    0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,0x20,
+    0x3d,0x20,0x6d,0x61,0x74,0x32,0x78,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,
+    0x33,0x20,0x5f,0x36,0x32,0x20,0x3d,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,
+    0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x5b,0x34,0x5d,0x2e,0x78,0x79,0x7a,0x20,
+    0x2d,0x20,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x2e,0x78,0x79,0x7a,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x2e,0x78,0x20,0x3d,0x20,
+    0x64,0x6f,0x74,0x28,0x6d,0x61,0x74,0x30,0x2c,0x20,0x5f,0x36,0x32,0x29,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x2e,0x79,0x20,0x3d,0x20,
+    0x64,0x6f,0x74,0x28,0x6d,0x61,0x74,0x31,0x2c,0x20,0x5f,0x36,0x32,0x29,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x2e,0x7a,0x20,0x3d,0x20,
+    0x64,0x6f,0x74,0x28,0x6d,0x61,0x74,0x32,0x78,0x2c,0x20,0x5f,0x36,0x32,0x29,0x3b,
+    0x0a,0x7d,0x0a,0x0a,0x00,
+};
+/*
+    #version 330
+    
+    uniform vec4 fs_params_lights[9];
+    uniform sampler2D Base_smp;
+    uniform sampler2D Bump_smp;
+    
+    in vec2 texCoord;
+    in vec3 viewVec;
+    in vec3 worldPos;
+    in vec3 tangent0;
+    in vec3 tangent1;
+    in vec3 tangent2;
+    layout(location = 0) out vec4 frag_color;
+    
+    void main()
+    {
+        vec4 _24 = texture(Base_smp, texCoord);
+        vec3 _41 = normalize((texture(Bump_smp, texCoord).xyz * 2.0) - vec3(1.0));
+        vec3 _48 = reflect(normalize(-viewVec), _41);
+        vec4 color = _24 * fs_params_lights[8].x;
+        int _63 = int(fs_params_lights[8].y);
+        for (int i = 0; i < _63; i++)
+        {
+            vec3 _80 = fs_params_lights[i].xyz - worldPos;
+            vec3 _95 = vec3(dot(tangent0, _80), dot(tangent1, _80), dot(tangent2, _80));
+            float _98 = dot(_95, _95);
+            vec3 _103 = _95 * inversesqrt(_98);
+            color += (((_24 * clamp(dot(_103, _41), 0.0, 1.0)) + vec4(0.60000002384185791015625 * pow(clamp(dot(_48, _103), 0.0, 1.0), 16.0))) * clamp((-fs_params_lights[i].w) * sqrt(_98) + 1.0, 0.0, 1.0));
+        }
+        frag_color = color;
+    }
+    
+*/
+static const char fs_lights_source_glsl330[1026] = {
+    0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x33,0x30,0x0a,0x0a,0x75,0x6e,
+    0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x66,0x73,0x5f,0x70,0x61,
+    0x72,0x61,0x6d,0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x5b,0x39,0x5d,0x3b,0x0a,
+    0x75,0x6e,0x69,0x66,0x6f,0x72,0x6d,0x20,0x73,0x61,0x6d,0x70,0x6c,0x65,0x72,0x32,
+    0x44,0x20,0x42,0x61,0x73,0x65,0x5f,0x73,0x6d,0x70,0x3b,0x0a,0x75,0x6e,0x69,0x66,
+    0x6f,0x72,0x6d,0x20,0x73,0x61,0x6d,0x70,0x6c,0x65,0x72,0x32,0x44,0x20,0x42,0x75,
+    0x6d,0x70,0x5f,0x73,0x6d,0x70,0x3b,0x0a,0x0a,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,
+    0x20,0x74,0x65,0x78,0x43,0x6f,0x6f,0x72,0x64,0x3b,0x0a,0x69,0x6e,0x20,0x76,0x65,
+    0x63,0x33,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x3b,0x0a,0x69,0x6e,0x20,0x76,
+    0x65,0x63,0x33,0x20,0x77,0x6f,0x72,0x6c,0x64,0x50,0x6f,0x73,0x3b,0x0a,0x69,0x6e,
+    0x20,0x76,0x65,0x63,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x30,0x3b,0x0a,
+    0x69,0x6e,0x20,0x76,0x65,0x63,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x31,
+    0x3b,0x0a,0x69,0x6e,0x20,0x76,0x65,0x63,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,
+    0x74,0x32,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,
+    0x69,0x6f,0x6e,0x20,0x3d,0x20,0x30,0x29,0x20,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,
+    0x34,0x20,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x0a,0x76,
+    0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,
+    0x20,0x76,0x65,0x63,0x34,0x20,0x5f,0x32,0x34,0x20,0x3d,0x20,0x74,0x65,0x78,0x74,
+    0x75,0x72,0x65,0x28,0x42,0x61,0x73,0x65,0x5f,0x73,0x6d,0x70,0x2c,0x20,0x74,0x65,
+    0x78,0x43,0x6f,0x6f,0x72,0x64,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,
+    0x33,0x20,0x5f,0x34,0x31,0x20,0x3d,0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x69,0x7a,
+    0x65,0x28,0x28,0x74,0x65,0x78,0x74,0x75,0x72,0x65,0x28,0x42,0x75,0x6d,0x70,0x5f,
+    0x73,0x6d,0x70,0x2c,0x20,0x74,0x65,0x78,0x43,0x6f,0x6f,0x72,0x64,0x29,0x2e,0x78,
+    0x79,0x7a,0x20,0x2a,0x20,0x32,0x2e,0x30,0x29,0x20,0x2d,0x20,0x76,0x65,0x63,0x33,
+    0x28,0x31,0x2e,0x30,0x29,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x33,
+    0x20,0x5f,0x34,0x38,0x20,0x3d,0x20,0x72,0x65,0x66,0x6c,0x65,0x63,0x74,0x28,0x6e,
+    0x6f,0x72,0x6d,0x61,0x6c,0x69,0x7a,0x65,0x28,0x2d,0x76,0x69,0x65,0x77,0x56,0x65,
+    0x63,0x29,0x2c,0x20,0x5f,0x34,0x31,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,
+    0x63,0x34,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x5f,0x32,0x34,0x20,0x2a,
+    0x20,0x66,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,
+    0x73,0x5b,0x38,0x5d,0x2e,0x78,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x6e,0x74,0x20,
+    0x5f,0x36,0x33,0x20,0x3d,0x20,0x69,0x6e,0x74,0x28,0x66,0x73,0x5f,0x70,0x61,0x72,
+    0x61,0x6d,0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x5b,0x38,0x5d,0x2e,0x79,0x29,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6f,0x72,0x20,0x28,0x69,0x6e,0x74,0x20,0x69,
+    0x20,0x3d,0x20,0x30,0x3b,0x20,0x69,0x20,0x3c,0x20,0x5f,0x36,0x33,0x3b,0x20,0x69,
+    0x2b,0x2b,0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,
+    0x20,0x20,0x76,0x65,0x63,0x33,0x20,0x5f,0x38,0x30,0x20,0x3d,0x20,0x66,0x73,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x5b,0x69,0x5d,
+    0x2e,0x78,0x79,0x7a,0x20,0x2d,0x20,0x77,0x6f,0x72,0x6c,0x64,0x50,0x6f,0x73,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x33,0x20,0x5f,0x39,
+    0x35,0x20,0x3d,0x20,0x76,0x65,0x63,0x33,0x28,0x64,0x6f,0x74,0x28,0x74,0x61,0x6e,
+    0x67,0x65,0x6e,0x74,0x30,0x2c,0x20,0x5f,0x38,0x30,0x29,0x2c,0x20,0x64,0x6f,0x74,
+    0x28,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x31,0x2c,0x20,0x5f,0x38,0x30,0x29,0x2c,
+    0x20,0x64,0x6f,0x74,0x28,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,0x2c,0x20,0x5f,
+    0x38,0x30,0x29,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x66,0x6c,
+    0x6f,0x61,0x74,0x20,0x5f,0x39,0x38,0x20,0x3d,0x20,0x64,0x6f,0x74,0x28,0x5f,0x39,
+    0x35,0x2c,0x20,0x5f,0x39,0x35,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,
+    0x20,0x76,0x65,0x63,0x33,0x20,0x5f,0x31,0x30,0x33,0x20,0x3d,0x20,0x5f,0x39,0x35,
+    0x20,0x2a,0x20,0x69,0x6e,0x76,0x65,0x72,0x73,0x65,0x73,0x71,0x72,0x74,0x28,0x5f,
+    0x39,0x38,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x63,0x6f,0x6c,
+    0x6f,0x72,0x20,0x2b,0x3d,0x20,0x28,0x28,0x28,0x5f,0x32,0x34,0x20,0x2a,0x20,0x63,
+    0x6c,0x61,0x6d,0x70,0x28,0x64,0x6f,0x74,0x28,0x5f,0x31,0x30,0x33,0x2c,0x20,0x5f,
+    0x34,0x31,0x29,0x2c,0x20,0x30,0x2e,0x30,0x2c,0x20,0x31,0x2e,0x30,0x29,0x29,0x20,
+    0x2b,0x20,0x76,0x65,0x63,0x34,0x28,0x30,0x2e,0x36,0x30,0x30,0x30,0x30,0x30,0x30,
+    0x32,0x33,0x38,0x34,0x31,0x38,0x35,0x37,0x39,0x31,0x30,0x31,0x35,0x36,0x32,0x35,
+    0x20,0x2a,0x20,0x70,0x6f,0x77,0x28,0x63,0x6c,0x61,0x6d,0x70,0x28,0x64,0x6f,0x74,
+    0x28,0x5f,0x34,0x38,0x2c,0x20,0x5f,0x31,0x30,0x33,0x29,0x2c,0x20,0x30,0x2e,0x30,
+    0x2c,0x20,0x31,0x2e,0x30,0x29,0x2c,0x20,0x31,0x36,0x2e,0x30,0x29,0x29,0x29,0x20,
+    0x2a,0x20,0x63,0x6c,0x61,0x6d,0x70,0x28,0x28,0x2d,0x66,0x73,0x5f,0x70,0x61,0x72,
+    0x61,0x6d,0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x5b,0x69,0x5d,0x2e,0x77,0x29,
+    0x20,0x2a,0x20,0x73,0x71,0x72,0x74,0x28,0x5f,0x39,0x38,0x29,0x20,0x2b,0x20,0x31,
+    0x2e,0x30,0x2c,0x20,0x30,0x2e,0x30,0x2c,0x20,0x31,0x2e,0x30,0x29,0x29,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x66,0x72,0x61,0x67,0x5f,0x63,
+    0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x7d,0x0a,
+    0x0a,0x00,
+};
 #endif /* SOKOL_GLCORE33 */
 #if defined(SOKOL_D3D11)
 /*
@@ -878,6 +1259,506 @@ static const char fs_pfx_source_hlsl5[618] = {
     0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,
     0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x7d,0x0a,0x00,
 };
+/*
+    cbuffer vs_params_pfx_inst : register(b0)
+    {
+        row_major float4x4 _26_mvp : packoffset(c0);
+        float4 _26_dx : packoffset(c4);
+        float4 _26_dy : packoffset(c5);
+    };
+    
+    
+    static float4 gl_Position;
+    static float4 inst_pos_size;
+    static float2 corner;
+    static float2 uv;
+    static float4 color;
+    static float4 inst_color;
+    
+    struct SPIRV_Cross_Input
+    {
+        float2 corner : TEXCOORD0;
+        float4 inst_pos_size : TEXCOORD1;
+        float4 inst_color : TEXCOORD2;
+    };
+    
+    struct SPIRV_Cross_Output
+    {
+        float2 uv : TEXCOORD0;
+        float4 color : TEXCOORD1;
+        float4 gl_Position : SV_Position;
+    };
+    
+    void vert_main()
+    {
+        gl_Position = mul(float4(inst_pos_size.xyz + (((_26_dx.xyz * corner.x) + (_26_dy.xyz * corner.y)) * inst_pos_size.w), 1.0f), _26_mvp);
+        uv = 0.5f.xx + (float2(0.5f, -0.5f) * corner);
+        color = inst_color;
+    }
+    
+    SPIRV_Cross_Output main(SPIRV_Cross_Input stage_input)
+    {
+        inst_pos_size = stage_input.inst_pos_size;
+        corner = stage_input.corner;
+        inst_color = stage_input.inst_color;
+        vert_main();
+        SPIRV_Cross_Output stage_output;
+        stage_output.gl_Position = gl_Position;
+        stage_output.uv = uv;
+        stage_output.color = color;
+        return stage_output;
+    }
+*/
+static const char vs_pfx_inst_source_hlsl5[1174] = {
+    0x63,0x62,0x75,0x66,0x66,0x65,0x72,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,
+    0x73,0x5f,0x70,0x66,0x78,0x5f,0x69,0x6e,0x73,0x74,0x20,0x3a,0x20,0x72,0x65,0x67,
+    0x69,0x73,0x74,0x65,0x72,0x28,0x62,0x30,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,
+    0x72,0x6f,0x77,0x5f,0x6d,0x61,0x6a,0x6f,0x72,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,
+    0x78,0x34,0x20,0x5f,0x32,0x36,0x5f,0x6d,0x76,0x70,0x20,0x3a,0x20,0x70,0x61,0x63,
+    0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x63,0x30,0x29,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x5f,0x32,0x36,0x5f,0x64,0x78,0x20,0x3a,
+    0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x63,0x34,0x29,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x5f,0x32,0x36,0x5f,
+    0x64,0x79,0x20,0x3a,0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,
+    0x63,0x35,0x29,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,
+    0x69,0x6f,0x6e,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x34,0x20,0x69,0x6e,0x73,0x74,0x5f,0x70,0x6f,0x73,0x5f,0x73,0x69,0x7a,0x65,
+    0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,
+    0x63,0x6f,0x72,0x6e,0x65,0x72,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,
+    0x6c,0x6f,0x61,0x74,0x32,0x20,0x75,0x76,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x73,
+    0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x69,0x6e,0x73,
+    0x74,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,0x74,
+    0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x49,0x6e,0x70,
+    0x75,0x74,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,
+    0x63,0x6f,0x72,0x6e,0x65,0x72,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,
+    0x44,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x69,
+    0x6e,0x73,0x74,0x5f,0x70,0x6f,0x73,0x5f,0x73,0x69,0x7a,0x65,0x20,0x3a,0x20,0x54,
+    0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,
+    0x6f,0x61,0x74,0x34,0x20,0x69,0x6e,0x73,0x74,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,
+    0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x32,0x3b,0x0a,0x7d,0x3b,0x0a,
+    0x0a,0x73,0x74,0x72,0x75,0x63,0x74,0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,
+    0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x0a,0x7b,0x0a,0x20,0x20,0x20,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x75,0x76,0x20,0x3a,0x20,0x54,0x45,0x58,
+    0x43,0x4f,0x4f,0x52,0x44,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x34,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,
+    0x4f,0x52,0x44,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,
+    0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3a,0x20,0x53,
+    0x56,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,
+    0x76,0x6f,0x69,0x64,0x20,0x76,0x65,0x72,0x74,0x5f,0x6d,0x61,0x69,0x6e,0x28,0x29,
+    0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,
+    0x6f,0x6e,0x20,0x3d,0x20,0x6d,0x75,0x6c,0x28,0x66,0x6c,0x6f,0x61,0x74,0x34,0x28,
+    0x69,0x6e,0x73,0x74,0x5f,0x70,0x6f,0x73,0x5f,0x73,0x69,0x7a,0x65,0x2e,0x78,0x79,
+    0x7a,0x20,0x2b,0x20,0x28,0x28,0x28,0x5f,0x32,0x36,0x5f,0x64,0x78,0x2e,0x78,0x79,
+    0x7a,0x20,0x2a,0x20,0x63,0x6f,0x72,0x6e,0x65,0x72,0x2e,0x78,0x29,0x20,0x2b,0x20,
+    0x28,0x5f,0x32,0x36,0x5f,0x64,0x79,0x2e,0x78,0x79,0x7a,0x20,0x2a,0x20,0x63,0x6f,
+    0x72,0x6e,0x65,0x72,0x2e,0x79,0x29,0x29,0x20,0x2a,0x20,0x69,0x6e,0x73,0x74,0x5f,
+    0x70,0x6f,0x73,0x5f,0x73,0x69,0x7a,0x65,0x2e,0x77,0x29,0x2c,0x20,0x31,0x2e,0x30,
+    0x66,0x29,0x2c,0x20,0x5f,0x32,0x36,0x5f,0x6d,0x76,0x70,0x29,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x75,0x76,0x20,0x3d,0x20,0x30,0x2e,0x35,0x66,0x2e,0x78,0x78,0x20,0x2b,
+    0x20,0x28,0x66,0x6c,0x6f,0x61,0x74,0x32,0x28,0x30,0x2e,0x35,0x66,0x2c,0x20,0x2d,
+    0x30,0x2e,0x35,0x66,0x29,0x20,0x2a,0x20,0x63,0x6f,0x72,0x6e,0x65,0x72,0x29,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x69,0x6e,0x73,
+    0x74,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x7d,0x0a,0x0a,0x53,0x50,0x49,0x52,
+    0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,0x6d,
+    0x61,0x69,0x6e,0x28,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,
+    0x49,0x6e,0x70,0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,
+    0x74,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x69,0x6e,0x73,0x74,0x5f,0x70,0x6f,
+    0x73,0x5f,0x73,0x69,0x7a,0x65,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,
+    0x6e,0x70,0x75,0x74,0x2e,0x69,0x6e,0x73,0x74,0x5f,0x70,0x6f,0x73,0x5f,0x73,0x69,
+    0x7a,0x65,0x3b,0x0a,0x20,0x20,0x20,0x20,0x63,0x6f,0x72,0x6e,0x65,0x72,0x20,0x3d,
+    0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x63,0x6f,0x72,
+    0x6e,0x65,0x72,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x6e,0x73,0x74,0x5f,0x63,0x6f,
+    0x6c,0x6f,0x72,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,
+    0x74,0x2e,0x69,0x6e,0x73,0x74,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x76,0x65,0x72,0x74,0x5f,0x6d,0x61,0x69,0x6e,0x28,0x29,0x3b,0x0a,0x20,
+    0x20,0x20,0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,
+    0x75,0x74,0x70,0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,
+    0x75,0x74,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,
+    0x74,0x70,0x75,0x74,0x2e,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,
+    0x20,0x3d,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,
+    0x2e,0x75,0x76,0x20,0x3d,0x20,0x75,0x76,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,
+    0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x63,0x6f,0x6c,0x6f,0x72,
+    0x20,0x3d,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x65,
+    0x74,0x75,0x72,0x6e,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,
+    0x74,0x3b,0x0a,0x7d,0x0a,0x00,
+};
+/*
+    cbuffer vs_params_lights : register(b0)
+    {
+        row_major float4x4 _20_mvp : packoffset(c0);
+        float4 _20_camPos : packoffset(c4);
+    };
+    
+    
+    static float4 gl_Position;
+    static float4 position;
+    static float2 texCoord;
+    static float2 uv;
+    static float3 worldPos;
+    static float3 tangent0;
+    static float3 mat0;
+    static float3 tangent1;
+    static float3 mat1;
+    static float3 tangent2;
+    static float3 mat2x;
+    static float3 viewVec;
+    
+    struct SPIRV_Cross_Input
+    {
+        float4 position : TEXCOORD0;
+        float2 uv : TEXCOORD1;
+        float3 mat0 : TEXCOORD2;
+        float3 mat1 : TEXCOORD3;
+        float3 mat2x : TEXCOORD4;
+    };
+    
+    struct SPIRV_Cross_Output
+    {
+        float2 texCoord : TEXCOORD0;
+        float3 worldPos : TEXCOORD1;
+        float3 viewVec : TEXCOORD2;
+        float3 tangent0 : TEXCOORD3;
+        float3 tangent1 : TEXCOORD4;
+        float3 tangent2 : TEXCOORD5;
+        float4 gl_Position : SV_Position;
+    };
+    
+    void vert_main()
+    {
+        gl_Position = mul(position, _20_mvp);
+        texCoord = uv;
+        worldPos = position.xyz;
+        tangent0 = mat0;
+        tangent1 = mat1;
+        tangent2 = mat2x;
+        float3 _62 = _20_camPos.xyz - position.xyz;
+        viewVec.x = dot(mat0, _62);
+        viewVec.y = dot(mat1, _62);
+        viewVec.z = dot(mat2x, _62);
+    }
+    
+    SPIRV_Cross_Output main(SPIRV_Cross_Input stage_input)
+    {
+        position = stage_input.position;
+        uv = stage_input.uv;
+        mat0 = stage_input.mat0;
+        mat1 = stage_input.mat1;
+        mat2x = stage_input.mat2x;
+        vert_main();
+        SPIRV_Cross_Output stage_output;
+        stage_output.gl_Position = gl_Position;
+        stage_output.texCoord = texCoord;
+        stage_output.worldPos = worldPos;
+        stage_output.viewVec = viewVec;
+        stage_output.tangent0 = tangent0;
+        stage_output.tangent1 = tangent1;
+        stage_output.tangent2 = tangent2;
+        return stage_output;
+    }
+*/
+static const char vs_lights_source_hlsl5[1737] = {
+    0x63,0x62,0x75,0x66,0x66,0x65,0x72,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,
+    0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x20,0x3a,0x20,0x72,0x65,0x67,0x69,0x73,
+    0x74,0x65,0x72,0x28,0x62,0x30,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x72,0x6f,
+    0x77,0x5f,0x6d,0x61,0x6a,0x6f,0x72,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x78,0x34,
+    0x20,0x5f,0x32,0x30,0x5f,0x6d,0x76,0x70,0x20,0x3a,0x20,0x70,0x61,0x63,0x6b,0x6f,
+    0x66,0x66,0x73,0x65,0x74,0x28,0x63,0x30,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,
+    0x6c,0x6f,0x61,0x74,0x34,0x20,0x5f,0x32,0x30,0x5f,0x63,0x61,0x6d,0x50,0x6f,0x73,
+    0x20,0x3a,0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x63,0x34,
+    0x29,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,
+    0x6c,0x6f,0x61,0x74,0x34,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,
+    0x6e,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,
+    0x20,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,
+    0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x74,0x65,0x78,0x43,0x6f,0x6f,0x72,
+    0x64,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,
+    0x20,0x75,0x76,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x33,0x20,0x77,0x6f,0x72,0x6c,0x64,0x50,0x6f,0x73,0x3b,0x0a,0x73,0x74,0x61,
+    0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,
+    0x6e,0x74,0x30,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x33,0x20,0x6d,0x61,0x74,0x30,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,
+    0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x31,0x3b,
+    0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x6d,
+    0x61,0x74,0x31,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,0x3b,0x0a,0x73,0x74,0x61,
+    0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x6d,0x61,0x74,0x32,0x78,
+    0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,
+    0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,0x74,
+    0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x49,0x6e,0x70,
+    0x75,0x74,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,
+    0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,
+    0x4f,0x52,0x44,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,
+    0x20,0x75,0x76,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x31,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x6d,0x61,0x74,0x30,
+    0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x32,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x6d,0x61,0x74,0x31,0x20,0x3a,0x20,
+    0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x33,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,
+    0x6c,0x6f,0x61,0x74,0x33,0x20,0x6d,0x61,0x74,0x32,0x78,0x20,0x3a,0x20,0x54,0x45,
+    0x58,0x43,0x4f,0x4f,0x52,0x44,0x34,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x73,0x74,0x72,
+    0x75,0x63,0x74,0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,
+    0x4f,0x75,0x74,0x70,0x75,0x74,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,
+    0x61,0x74,0x32,0x20,0x74,0x65,0x78,0x43,0x6f,0x6f,0x72,0x64,0x20,0x3a,0x20,0x54,
+    0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,
+    0x6f,0x61,0x74,0x33,0x20,0x77,0x6f,0x72,0x6c,0x64,0x50,0x6f,0x73,0x20,0x3a,0x20,
+    0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,
+    0x6c,0x6f,0x61,0x74,0x33,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x20,0x3a,0x20,
+    0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x32,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,
+    0x6c,0x6f,0x61,0x74,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x30,0x20,0x3a,
+    0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x33,0x3b,0x0a,0x20,0x20,0x20,0x20,
+    0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x31,0x20,
+    0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x34,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,
+    0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x35,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,
+    0x74,0x69,0x6f,0x6e,0x20,0x3a,0x20,0x53,0x56,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,
+    0x6f,0x6e,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x76,0x65,0x72,
+    0x74,0x5f,0x6d,0x61,0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x67,
+    0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x6d,0x75,0x6c,
+    0x28,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x2c,0x20,0x5f,0x32,0x30,0x5f,0x6d,
+    0x76,0x70,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x74,0x65,0x78,0x43,0x6f,0x6f,0x72,
+    0x64,0x20,0x3d,0x20,0x75,0x76,0x3b,0x0a,0x20,0x20,0x20,0x20,0x77,0x6f,0x72,0x6c,
+    0x64,0x50,0x6f,0x73,0x20,0x3d,0x20,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x2e,
+    0x78,0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,
+    0x30,0x20,0x3d,0x20,0x6d,0x61,0x74,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x74,0x61,
+    0x6e,0x67,0x65,0x6e,0x74,0x31,0x20,0x3d,0x20,0x6d,0x61,0x74,0x31,0x3b,0x0a,0x20,
+    0x20,0x20,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,0x20,0x3d,0x20,0x6d,0x61,
+    0x74,0x32,0x78,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,
+    0x5f,0x36,0x32,0x20,0x3d,0x20,0x5f,0x32,0x30,0x5f,0x63,0x61,0x6d,0x50,0x6f,0x73,
+    0x2e,0x78,0x79,0x7a,0x20,0x2d,0x20,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x2e,
+    0x78,0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,
+    0x2e,0x78,0x20,0x3d,0x20,0x64,0x6f,0x74,0x28,0x6d,0x61,0x74,0x30,0x2c,0x20,0x5f,
+    0x36,0x32,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,
+    0x2e,0x79,0x20,0x3d,0x20,0x64,0x6f,0x74,0x28,0x6d,0x61,0x74,0x31,0x2c,0x20,0x5f,
+    0x36,0x32,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,
+    0x2e,0x7a,0x20,0x3d,0x20,0x64,0x6f,0x74,0x28,0x6d,0x61,0x74,0x32,0x78,0x2c,0x20,
+    0x5f,0x36,0x32,0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,
+    0x72,0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,0x6d,0x61,0x69,0x6e,
+    0x28,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x49,0x6e,0x70,
+    0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x29,0x0a,
+    0x7b,0x0a,0x20,0x20,0x20,0x20,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,
+    0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x70,0x6f,0x73,
+    0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x20,0x20,0x20,0x20,0x75,0x76,0x20,0x3d,0x20,
+    0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x75,0x76,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x6d,0x61,0x74,0x30,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,
+    0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x6d,0x61,0x74,0x30,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x6d,0x61,0x74,0x31,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,
+    0x70,0x75,0x74,0x2e,0x6d,0x61,0x74,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x6d,0x61,
+    0x74,0x32,0x78,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,
+    0x74,0x2e,0x6d,0x61,0x74,0x32,0x78,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,
+    0x74,0x5f,0x6d,0x61,0x69,0x6e,0x28,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x53,0x50,
+    0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,
+    0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x20,
+    0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,
+    0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x67,0x6c,
+    0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,
+    0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x74,0x65,0x78,0x43,
+    0x6f,0x6f,0x72,0x64,0x20,0x3d,0x20,0x74,0x65,0x78,0x43,0x6f,0x6f,0x72,0x64,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,
+    0x74,0x2e,0x77,0x6f,0x72,0x6c,0x64,0x50,0x6f,0x73,0x20,0x3d,0x20,0x77,0x6f,0x72,
+    0x6c,0x64,0x50,0x6f,0x73,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,
+    0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x20,
+    0x3d,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,
+    0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x74,0x61,0x6e,0x67,
+    0x65,0x6e,0x74,0x30,0x20,0x3d,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x30,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,
+    0x74,0x2e,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x31,0x20,0x3d,0x20,0x74,0x61,0x6e,
+    0x67,0x65,0x6e,0x74,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,
+    0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,
+    0x20,0x3d,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,
+    0x74,0x70,0x75,0x74,0x3b,0x0a,0x7d,0x0a,0x00,
+};
+/*
+    cbuffer fs_params_lights : register(b0)
+    {
+        float4 _57_lights[8] : packoffset(c0);
+        float _57_ambient : packoffset(c8);
+        float _57_lightCount : packoffset(c8.y);
+    };
+    
+    Texture2D<float4> Base : register(t0);
+    SamplerState smp : register(s0);
+    Texture2D<float4> Bump : register(t1);
+    
+    static float2 texCoord;
+    static float3 viewVec;
+    static float3 worldPos;
+    static float3 tangent0;
+    static float3 tangent1;
+    static float3 tangent2;
+    static float4 frag_color;
+    
+    struct SPIRV_Cross_Input
+    {
+        float2 texCoord : TEXCOORD0;
+        float3 worldPos : TEXCOORD1;
+        float3 viewVec : TEXCOORD2;
+        float3 tangent0 : TEXCOORD3;
+        float3 tangent1 : TEXCOORD4;
+        float3 tangent2 : TEXCOORD5;
+    };
+    
+    struct SPIRV_Cross_Output
+    {
+        float4 frag_color : SV_Target0;
+    };
+    
+    void frag_main()
+    {
+        float4 _24 = Base.Sample(smp, texCoord);
+        float3 _41 = normalize((Bump.Sample(smp, texCoord).xyz * 2.0f) - 1.0f.xxx);
+        float3 _48 = reflect(normalize(-viewVec), _41);
+        float4 color = _24 * _57_ambient;
+        int _63 = int(_57_lightCount);
+        for (int i = 0; i < _63; i++)
+        {
+            float3 _80 = _57_lights[i].xyz - worldPos;
+            float3 _95 = float3(dot(tangent0, _80), dot(tangent1, _80), dot(tangent2, _80));
+            float _98 = dot(_95, _95);
+            float3 _103 = _95 * rsqrt(_98);
+            color += (((_24 * clamp(dot(_103, _41), 0.0f, 1.0f)) + (0.60000002384185791015625f * pow(clamp(dot(_48, _103), 0.0f, 1.0f), 16.0f)).xxxx) * clamp(mad(-_57_lights[i].w, sqrt(_98), 1.0f), 0.0f, 1.0f));
+        }
+        frag_color = color;
+    }
+    
+    SPIRV_Cross_Output main(SPIRV_Cross_Input stage_input)
+    {
+        texCoord = stage_input.texCoord;
+        worldPos = stage_input.worldPos;
+        viewVec = stage_input.viewVec;
+        tangent0 = stage_input.tangent0;
+        tangent1 = stage_input.tangent1;
+        tangent2 = stage_input.tangent2;
+        frag_main();
+        SPIRV_Cross_Output stage_output;
+        stage_output.frag_color = frag_color;
+        return stage_output;
+    }
+*/
+static const char fs_lights_source_hlsl5[1918] = {
+    0x63,0x62,0x75,0x66,0x66,0x65,0x72,0x20,0x66,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,
+    0x73,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x20,0x3a,0x20,0x72,0x65,0x67,0x69,0x73,
+    0x74,0x65,0x72,0x28,0x62,0x30,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,
+    0x6f,0x61,0x74,0x34,0x20,0x5f,0x35,0x37,0x5f,0x6c,0x69,0x67,0x68,0x74,0x73,0x5b,
+    0x38,0x5d,0x20,0x3a,0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,
+    0x63,0x30,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,
+    0x35,0x37,0x5f,0x61,0x6d,0x62,0x69,0x65,0x6e,0x74,0x20,0x3a,0x20,0x70,0x61,0x63,
+    0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x63,0x38,0x29,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x35,0x37,0x5f,0x6c,0x69,0x67,0x68,0x74,
+    0x43,0x6f,0x75,0x6e,0x74,0x20,0x3a,0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,0x73,
+    0x65,0x74,0x28,0x63,0x38,0x2e,0x79,0x29,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x54,0x65,
+    0x78,0x74,0x75,0x72,0x65,0x32,0x44,0x3c,0x66,0x6c,0x6f,0x61,0x74,0x34,0x3e,0x20,
+    0x42,0x61,0x73,0x65,0x20,0x3a,0x20,0x72,0x65,0x67,0x69,0x73,0x74,0x65,0x72,0x28,
+    0x74,0x30,0x29,0x3b,0x0a,0x53,0x61,0x6d,0x70,0x6c,0x65,0x72,0x53,0x74,0x61,0x74,
+    0x65,0x20,0x73,0x6d,0x70,0x20,0x3a,0x20,0x72,0x65,0x67,0x69,0x73,0x74,0x65,0x72,
+    0x28,0x73,0x30,0x29,0x3b,0x0a,0x54,0x65,0x78,0x74,0x75,0x72,0x65,0x32,0x44,0x3c,
+    0x66,0x6c,0x6f,0x61,0x74,0x34,0x3e,0x20,0x42,0x75,0x6d,0x70,0x20,0x3a,0x20,0x72,
+    0x65,0x67,0x69,0x73,0x74,0x65,0x72,0x28,0x74,0x31,0x29,0x3b,0x0a,0x0a,0x73,0x74,
+    0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x74,0x65,0x78,0x43,
+    0x6f,0x6f,0x72,0x64,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,
+    0x61,0x74,0x33,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x3b,0x0a,0x73,0x74,0x61,
+    0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x77,0x6f,0x72,0x6c,0x64,
+    0x50,0x6f,0x73,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x30,0x3b,0x0a,0x73,0x74,0x61,
+    0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,
+    0x6e,0x74,0x31,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,0x3b,0x0a,0x73,0x74,0x61,
+    0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x66,0x72,0x61,0x67,0x5f,
+    0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,0x74,0x20,0x53,
+    0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x49,0x6e,0x70,0x75,0x74,
+    0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x74,0x65,
+    0x78,0x43,0x6f,0x6f,0x72,0x64,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,
+    0x44,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x77,
+    0x6f,0x72,0x6c,0x64,0x50,0x6f,0x73,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,
+    0x52,0x44,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,
+    0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,
+    0x52,0x44,0x32,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,
+    0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x30,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,
+    0x4f,0x52,0x44,0x33,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,
+    0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x31,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,
+    0x4f,0x4f,0x52,0x44,0x34,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,
+    0x33,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,0x20,0x3a,0x20,0x54,0x45,0x58,
+    0x43,0x4f,0x4f,0x52,0x44,0x35,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,
+    0x63,0x74,0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,
+    0x75,0x74,0x70,0x75,0x74,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x34,0x20,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3a,0x20,
+    0x53,0x56,0x5f,0x54,0x61,0x72,0x67,0x65,0x74,0x30,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,
+    0x76,0x6f,0x69,0x64,0x20,0x66,0x72,0x61,0x67,0x5f,0x6d,0x61,0x69,0x6e,0x28,0x29,
+    0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x5f,0x32,
+    0x34,0x20,0x3d,0x20,0x42,0x61,0x73,0x65,0x2e,0x53,0x61,0x6d,0x70,0x6c,0x65,0x28,
+    0x73,0x6d,0x70,0x2c,0x20,0x74,0x65,0x78,0x43,0x6f,0x6f,0x72,0x64,0x29,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x5f,0x34,0x31,0x20,0x3d,
+    0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x69,0x7a,0x65,0x28,0x28,0x42,0x75,0x6d,0x70,
+    0x2e,0x53,0x61,0x6d,0x70,0x6c,0x65,0x28,0x73,0x6d,0x70,0x2c,0x20,0x74,0x65,0x78,
+    0x43,0x6f,0x6f,0x72,0x64,0x29,0x2e,0x78,0x79,0x7a,0x20,0x2a,0x20,0x32,0x2e,0x30,
+    0x66,0x29,0x20,0x2d,0x20,0x31,0x2e,0x30,0x66,0x2e,0x78,0x78,0x78,0x29,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x5f,0x34,0x38,0x20,0x3d,
+    0x20,0x72,0x65,0x66,0x6c,0x65,0x63,0x74,0x28,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x69,
+    0x7a,0x65,0x28,0x2d,0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x29,0x2c,0x20,0x5f,0x34,
+    0x31,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x63,
+    0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x5f,0x32,0x34,0x20,0x2a,0x20,0x5f,0x35,0x37,
+    0x5f,0x61,0x6d,0x62,0x69,0x65,0x6e,0x74,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x6e,
+    0x74,0x20,0x5f,0x36,0x33,0x20,0x3d,0x20,0x69,0x6e,0x74,0x28,0x5f,0x35,0x37,0x5f,
+    0x6c,0x69,0x67,0x68,0x74,0x43,0x6f,0x75,0x6e,0x74,0x29,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x66,0x6f,0x72,0x20,0x28,0x69,0x6e,0x74,0x20,0x69,0x20,0x3d,0x20,0x30,0x3b,
+    0x20,0x69,0x20,0x3c,0x20,0x5f,0x36,0x33,0x3b,0x20,0x69,0x2b,0x2b,0x29,0x0a,0x20,
+    0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,
+    0x61,0x74,0x33,0x20,0x5f,0x38,0x30,0x20,0x3d,0x20,0x5f,0x35,0x37,0x5f,0x6c,0x69,
+    0x67,0x68,0x74,0x73,0x5b,0x69,0x5d,0x2e,0x78,0x79,0x7a,0x20,0x2d,0x20,0x77,0x6f,
+    0x72,0x6c,0x64,0x50,0x6f,0x73,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,
+    0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x5f,0x39,0x35,0x20,0x3d,0x20,0x66,0x6c,0x6f,
+    0x61,0x74,0x33,0x28,0x64,0x6f,0x74,0x28,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x30,
+    0x2c,0x20,0x5f,0x38,0x30,0x29,0x2c,0x20,0x64,0x6f,0x74,0x28,0x74,0x61,0x6e,0x67,
+    0x65,0x6e,0x74,0x31,0x2c,0x20,0x5f,0x38,0x30,0x29,0x2c,0x20,0x64,0x6f,0x74,0x28,
+    0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,0x2c,0x20,0x5f,0x38,0x30,0x29,0x29,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,
+    0x39,0x38,0x20,0x3d,0x20,0x64,0x6f,0x74,0x28,0x5f,0x39,0x35,0x2c,0x20,0x5f,0x39,
+    0x35,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x33,0x20,0x5f,0x31,0x30,0x33,0x20,0x3d,0x20,0x5f,0x39,0x35,0x20,0x2a,0x20,
+    0x72,0x73,0x71,0x72,0x74,0x28,0x5f,0x39,0x38,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,
+    0x20,0x20,0x20,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x2b,0x3d,0x20,0x28,0x28,0x28,
+    0x5f,0x32,0x34,0x20,0x2a,0x20,0x63,0x6c,0x61,0x6d,0x70,0x28,0x64,0x6f,0x74,0x28,
+    0x5f,0x31,0x30,0x33,0x2c,0x20,0x5f,0x34,0x31,0x29,0x2c,0x20,0x30,0x2e,0x30,0x66,
+    0x2c,0x20,0x31,0x2e,0x30,0x66,0x29,0x29,0x20,0x2b,0x20,0x28,0x30,0x2e,0x36,0x30,
+    0x30,0x30,0x30,0x30,0x30,0x32,0x33,0x38,0x34,0x31,0x38,0x35,0x37,0x39,0x31,0x30,
+    0x31,0x35,0x36,0x32,0x35,0x66,0x20,0x2a,0x20,0x70,0x6f,0x77,0x28,0x63,0x6c,0x61,
+    0x6d,0x70,0x28,0x64,0x6f,0x74,0x28,0x5f,0x34,0x38,0x2c,0x20,0x5f,0x31,0x30,0x33,
+    0x29,0x2c,0x20,0x30,0x2e,0x30,0x66,0x2c,0x20,0x31,0x2e,0x30,0x66,0x29,0x2c,0x20,
+    0x31,0x36,0x2e,0x30,0x66,0x29,0x29,0x2e,0x78,0x78,0x78,0x78,0x29,0x20,0x2a,0x20,
+    0x63,0x6c,0x61,0x6d,0x70,0x28,0x6d,0x61,0x64,0x28,0x2d,0x5f,0x35,0x37,0x5f,0x6c,
+    0x69,0x67,0x68,0x74,0x73,0x5b,0x69,0x5d,0x2e,0x77,0x2c,0x20,0x73,0x71,0x72,0x74,
+    0x28,0x5f,0x39,0x38,0x29,0x2c,0x20,0x31,0x2e,0x30,0x66,0x29,0x2c,0x20,0x30,0x2e,
+    0x30,0x66,0x2c,0x20,0x31,0x2e,0x30,0x66,0x29,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,
+    0x7d,0x0a,0x20,0x20,0x20,0x20,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,
+    0x20,0x3d,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x7d,0x0a,0x0a,0x53,0x50,0x49,
+    0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,
+    0x6d,0x61,0x69,0x6e,0x28,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,
+    0x5f,0x49,0x6e,0x70,0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,
+    0x75,0x74,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x74,0x65,0x78,0x43,0x6f,0x6f,
+    0x72,0x64,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,
+    0x2e,0x74,0x65,0x78,0x43,0x6f,0x6f,0x72,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,0x77,
+    0x6f,0x72,0x6c,0x64,0x50,0x6f,0x73,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,
+    0x69,0x6e,0x70,0x75,0x74,0x2e,0x77,0x6f,0x72,0x6c,0x64,0x50,0x6f,0x73,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x76,0x69,0x65,0x77,0x56,0x65,0x63,0x20,0x3d,0x20,0x73,0x74,
+    0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x76,0x69,0x65,0x77,0x56,0x65,
+    0x63,0x3b,0x0a,0x20,0x20,0x20,0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x30,0x20,
+    0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x74,0x61,
+    0x6e,0x67,0x65,0x6e,0x74,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x74,0x61,0x6e,0x67,
+    0x65,0x6e,0x74,0x31,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,
+    0x75,0x74,0x2e,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x31,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,
+    0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x74,0x61,0x6e,0x67,0x65,0x6e,0x74,0x32,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x72,0x61,0x67,0x5f,0x6d,0x61,0x69,0x6e,0x28,
+    0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,
+    0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,
+    0x6f,0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,
+    0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,
+    0x6c,0x6f,0x72,0x20,0x3d,0x20,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x73,0x74,0x61,
+    0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x7d,0x0a,0x00,
+};
 #endif /* SOKOL_D3D11 */
 #if !defined(SOKOL_GFX_INCLUDED)
   #error "Please include sokol_gfx.h before shaders.h"
@@ -1050,3 +1931,171 @@ static inline const sg_shader_desc* shd_pfx_shader_desc(sg_backend backend) {
   #endif /* SOKOL_D3D11 */
   return 0;
 }
+static inline const sg_shader_desc* shd_pfx_inst_shader_desc(sg_backend backend) {
+  #if defined(SOKOL_GLCORE33)
+  if (backend == SG_BACKEND_GLCORE33) {
+    static sg_shader_desc desc;
+    static bool valid;
+    if (!valid) {
+      valid = true;
+      desc.attrs[0].name = "corner";
+      desc.attrs[1].name = "inst_pos_size";
+      desc.attrs[2].name = "inst_color";
+      desc.vs.source = vs_pfx_inst_source_glsl330;
+      desc.vs.entry = "main";
+      desc.vs.uniform_blocks[0].size = 96;
+      desc.vs.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+      desc.vs.uniform_blocks[0].uniforms[0].name = "vs_params_pfx_inst";
+      desc.vs.uniform_blocks[0].uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
+      desc.vs.uniform_blocks[0].uniforms[0].array_count = 6;
+      desc.fs.source = fs_pfx_source_glsl330;
+      desc.fs.entry = "main";
+      desc.fs.images[0].used = true;
+      desc.fs.images[0].multisampled = false;
+      desc.fs.images[0].image_type = SG_IMAGETYPE_2D;
+      desc.fs.images[0].sample_type = SG_IMAGESAMPLETYPE_FLOAT;
+      desc.fs.samplers[0].used = true;
+      desc.fs.samplers[0].sampler_type = SG_SAMPLERTYPE_FILTERING;
+      desc.fs.image_sampler_pairs[0].used = true;
+      desc.fs.image_sampler_pairs[0].image_slot = 0;
+      desc.fs.image_sampler_pairs[0].sampler_slot = 0;
+      desc.fs.image_sampler_pairs[0].glsl_name = "tex0_smp";
+      desc.label = "shd_pfx_inst_shader";
+    }
+    return &desc;
+  }
+  #endif /* SOKOL_GLCORE33 */
+  #if defined(SOKOL_D3D11)
+  if (backend == SG_BACKEND_D3D11) {
+    static sg_shader_desc desc;
+    static bool valid;
+    if (!valid) {
+      valid = true;
+      desc.attrs[0].sem_name = "TEXCOORD";
+      desc.attrs[0].sem_index = 0;
+      desc.attrs[1].sem_name = "TEXCOORD";
+      desc.attrs[1].sem_index = 1;
+      desc.attrs[2].sem_name = "TEXCOORD";
+      desc.attrs[2].sem_index = 2;
+      desc.vs.source = vs_pfx_inst_source_hlsl5;
+      desc.vs.d3d11_target = "vs_5_0";
+      desc.vs.entry = "main";
+      desc.vs.uniform_blocks[0].size = 96;
+      desc.vs.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+      desc.fs.source = fs_pfx_source_hlsl5;
+      desc.fs.d3d11_target = "ps_5_0";
+      desc.fs.entry = "main";
+      desc.fs.images[0].used = true;
+      desc.fs.images[0].multisampled = false;
+      desc.fs.images[0].image_type = SG_IMAGETYPE_2D;
+      desc.fs.images[0].sample_type = SG_IMAGESAMPLETYPE_FLOAT;
+      desc.fs.samplers[0].used = true;
+      desc.fs.samplers[0].sampler_type = SG_SAMPLERTYPE_FILTERING;
+      desc.fs.image_sampler_pairs[0].used = true;
+      desc.fs.image_sampler_pairs[0].image_slot = 0;
+      desc.fs.image_sampler_pairs[0].sampler_slot = 0;
+      desc.label = "shd_pfx_inst_shader";
+    }
+    return &desc;
+  }
+  #endif /* SOKOL_D3D11 */
+  return 0;
+}
+static inline const sg_shader_desc* shd_lights_shader_desc(sg_backend backend) {
+  #if defined(SOKOL_GLCORE33)
+  if (backend == SG_BACKEND_GLCORE33) {
+    static sg_shader_desc desc;
+    static bool valid;
+    if (!valid) {
+      valid = true;
+      desc.attrs[0].name = "position";
+      desc.attrs[1].name = "uv";
+      desc.attrs[2].name = "mat0";
+      desc.attrs[3].name = "mat1";
+      desc.attrs[4].name = "mat2x";
+      desc.vs.source = vs_lights_source_glsl330;
+      desc.vs.entry = "main";
+      desc.vs.uniform_blocks[0].size = 80;
+      desc.vs.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+      desc.vs.uniform_blocks[0].uniforms[0].name = "vs_params_lights";
+      desc.vs.uniform_blocks[0].uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
+      desc.vs.uniform_blocks[0].uniforms[0].array_count = 5;
+      desc.fs.source = fs_lights_source_glsl330;
+      desc.fs.entry = "main";
+      desc.fs.uniform_blocks[0].size = 144;
+      desc.fs.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+      desc.fs.uniform_blocks[0].uniforms[0].name = "fs_params_lights";
+      desc.fs.uniform_blocks[0].uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
+      desc.fs.uniform_blocks[0].uniforms[0].array_count = 9;
+      desc.fs.images[0].used = true;
+      desc.fs.images[0].multisampled = false;
+      desc.fs.images[0].image_type = SG_IMAGETYPE_2D;
+      desc.fs.images[0].sample_type = SG_IMAGESAMPLETYPE_FLOAT;
+      desc.fs.images[1].used = true;
+      desc.fs.images[1].multisampled = false;
+      desc.fs.images[1].image_type = SG_IMAGETYPE_2D;
+      desc.fs.images[1].sample_type = SG_IMAGESAMPLETYPE_FLOAT;
+      desc.fs.samplers[0].used = true;
+      desc.fs.samplers[0].sampler_type = SG_SAMPLERTYPE_FILTERING;
+      desc.fs.image_sampler_pairs[0].used = true;
+      desc.fs.image_sampler_pairs[0].image_slot = 0;
+      desc.fs.image_sampler_pairs[0].sampler_slot = 0;
+      desc.fs.image_sampler_pairs[0].glsl_name = "Base_smp";
+      desc.fs.image_sampler_pairs[1].used = true;
+      desc.fs.image_sampler_pairs[1].image_slot = 1;
+      desc.fs.image_sampler_pairs[1].sampler_slot = 0;
+      desc.fs.image_sampler_pairs[1].glsl_name = "Bump_smp";
+      desc.label = "shd_lights_shader";
+    }
+    return &desc;
+  }
+  #endif /* SOKOL_GLCORE33 */
+  #if defined(SOKOL_D3D11)
+  if (backend == SG_BACKEND_D3D11) {
+    static sg_shader_desc desc;
+    static bool valid;
+    if (!valid) {
+      valid = true;
+      desc.attrs[0].sem_name = "TEXCOORD";
+      desc.attrs[0].sem_index = 0;
+      desc.attrs[1].sem_name = "TEXCOORD";
+      desc.attrs[1].sem_index = 1;
+      desc.attrs[2].sem_name = "TEXCOORD";
+      desc.attrs[2].sem_index = 2;
+      desc.attrs[3].sem_name = "TEXCOORD";
+      desc.attrs[3].sem_index = 3;
+      desc.attrs[4].sem_name = "TEXCOORD";
+      desc.attrs[4].sem_index = 4;
+      desc.vs.source = vs_lights_source_hlsl5;
+      desc.vs.d3d11_target = "vs_5_0";
+      desc.vs.entry = "main";
+      desc.vs.uniform_blocks[0].size = 80;
+      desc.vs.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+      desc.fs.source = fs_lights_source_hlsl5;
+      desc.fs.d3d11_target = "ps_5_0";
+      desc.fs.entry = "main";
+      desc.fs.uniform_blocks[0].size = 144;
+      desc.fs.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+      desc.fs.images[0].used = true;
+      desc.fs.images[0].multisampled = false;
+      desc.fs.images[0].image_type = SG_IMAGETYPE_2D;
+      desc.fs.images[0].sample_type = SG_IMAGESAMPLETYPE_FLOAT;
+      desc.fs.images[1].used = true;
+      desc.fs.images[1].multisampled = false;
+      desc.fs.images[1].image_type = SG_IMAGETYPE_2D;
+      desc.fs.images[1].sample_type = SG_IMAGESAMPLETYPE_FLOAT;
+      desc.fs.samplers[0].used = true;
+      desc.fs.samplers[0].sampler_type = SG_SAMPLERTYPE_FILTERING;
+      desc.fs.image_sampler_pairs[0].used = true;
+      desc.fs.image_sampler_pairs[0].image_slot = 0;
+      desc.fs.image_sampler_pairs[0].sampler_slot = 0;
+      desc.fs.image_sampler_pairs[1].used = true;
+      desc.fs.image_sampler_pairs[1].image_slot = 1;
+      desc.fs.image_sampler_pairs[1].sampler_slot = 0;
+      desc.label = "shd_lights_shader";
+    }
+    return &desc;
+  }
+  #endif /* SOKOL_D3D11 */
+  return 0;
+}
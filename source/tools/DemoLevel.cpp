@@ -0,0 +1,93 @@
+// Demo level builder
+// Writes the level file of the demo (the five rooms of the original Humus demo with their portals and lights).
+//
+// Usage:
+//   DemoLevel [out file]   - defaults to data/demo.lvl
+#include "../framework/Level.h"
+#include <stdio.h>
+
+// Add a portal in both directions between two sectors
+static void add_portal_pair(LevelBuilder& builder, uint32_t sector0, uint32_t sector1, const vec3& c0, const vec3& c1, const vec3& c2) {
+  builder.addPortal(sector0, sector1, c0, c1, c2);
+  builder.addPortal(sector1, sector0, c0, c1, c2);
+}
+
+// Lights all use the same fire particle system
+static void add_light(LevelBuilder& builder, uint32_t sector, const vec3& position, float radius, float xs, float ys, float zs) {
+  LevelLight light = {};
+  light.position[0] = position.x;
+  light.position[1] = position.y;
+  light.position[2] = position.z;
+  light.radius = radius;
+  light.offsetScale[0] = xs;
+  light.offsetScale[1] = ys;
+  light.offsetScale[2] = zs;
+
+  LevelParticles& particles = light.particles;
+  particles.spawnRate = 400;
+  particles.speed = 70;
+  particles.speedSpread = 20;
+  particles.life = 3.0f;
+  particles.lifeSpread = 0;
+  particles.directionalForce[1] = -10;
+  particles.frictionFactor = 0.95f;
+  particles.size = 15;
+  particles.sizeSpread = 5;
+  for (unsigned int i = 0; i < 6; i++) {
+    vec4 color0(0.05f * i, 0.01f * i, 0, 0);
+    vec4 color1(0.05f * 6, 0.05f * i + 0.06f, 0.02f * i, 0);
+    for (unsigned int c = 0; c < 4; c++) {
+      particles.colors[i][c] = color0[c];
+      particles.colors[6 + i][c] = color1[c];
+    }
+  }
+
+  builder.addLight(sector, light);
+}
+
+int main(int argc, char* argv[]) {
+  const char* outFile = (argc > 1) ? argv[1] : "data/demo.lvl";
+
+  LevelBuilder builder;
+  builder.addSector("data/room0.hmdl", vec3(0, 256, 0));
+  builder.addSector("data/room1.hmdl", vec3(-384, 256, 3072));
+  builder.addSector("data/room2.hmdl", vec3(1536, 256, 2688));
+  builder.addSector("data/room3.hmdl", vec3(-1024, -768, 2688));
+  builder.addSector("data/room4.hmdl", vec3(-2304, 256, 2688));
+
+  // Portals are added in the order of the sector portal lists
+  add_portal_pair(builder, 0, 1, vec3(-384, 384, 1024), vec3(-128, 384, 1024), vec3(-384, 0, 1024));
+  add_portal_pair(builder, 1, 2, vec3(512, 384, 2816), vec3(512, 384, 3072), vec3(512, 0, 2816));
+  add_portal_pair(builder, 2, 3, vec3(512, -256, 2304), vec3(512, -256, 2560), vec3(512, -640, 2304));
+  add_portal_pair(builder, 1, 4, vec3(-1280, 384, 1664), vec3(-1280, 384, 1920), vec3(-1280, 128, 1664));
+  add_portal_pair(builder, 1, 4, vec3(-1280, 192, 3840), vec3(-1280, 192, 4096), vec3(-1280, -256, 3840));
+
+  add_light(builder, 0, vec3(0, 128, 0), 800, 100, 100, 100);
+
+  add_light(builder, 1, vec3(-256, 224, 1800), 650, 100, 80, 100);
+  add_light(builder, 1, vec3(-512, 128, 3100), 900, 100, 100, 300);
+
+  add_light(builder, 2, vec3(1300, 128, 2700), 800, 100, 100, 200);
+
+  add_light(builder, 3, vec3(-100, -700, 2432), 600, 50, 50, 50);
+  add_light(builder, 3, vec3(-1450, -700, 2900), 1200, 250, 80, 250);
+
+  add_light(builder, 4, vec3(-2200, 256, 2300), 800, 100, 100, 100);
+  add_light(builder, 4, vec3(-2000, 0, 4000), 800, 100, 100, 100);
+
+  if (!save_level_to_file(outFile, builder)) {
+    printf("Failed to write %s\n", outFile);
+    return 1;
+  }
+
+  // Check the file loads
+  MappedFile levelFile;
+  LevelData level;
+  if (!load_level_from_file(outFile, levelFile, level)) {
+    printf("Failed to validate %s\n", outFile);
+    return 1;
+  }
+
+  printf("Wrote %s (%u sectors, %u portals, %u lights)\n", outFile, level.header->sectorCount, level.header->portalCount, level.header->lightCount);
+  return 0;
+}
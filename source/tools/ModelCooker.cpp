@@ -0,0 +1,75 @@
+// Offline model cooker
+// Converts level models to the cooked format (world offset applied, fixed vertex layout, triangles with
+// 16 bit indices where possible) so they can be mapped and uploaded directly at load time.
+//
+// Usage:
+//   ModelCooker <level file>                  - cook all sector models of a level next to the source files
+//   ModelCooker <model file> <out file> [x y z] - cook a single model with an optional offset
+#include "../framework/Model.h"
+#include "../framework/Level.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static bool cook_file(const char* inFile, const char* outFile, const vec3& offset) {
+  Model model;
+  Model cooked;
+  if (!load_model_from_file(inFile, model)) {
+    printf("Failed to load model %s\n", inFile);
+    return false;
+  }
+  if (!cook_model(model, offset, cooked)) {
+    printf("Unsupported model layout %s\n", inFile);
+    return false;
+  }
+  if (!save_cooked_model(outFile, inFile, cooked, offset)) {
+    printf("Failed to write %s\n", outFile);
+    return false;
+  }
+
+  // Check the file round trips
+  Model loaded;
+  vec3 min, max;
+  std::vector<vec3> batchMin, batchMax;
+  if (!load_cooked_model(outFile, inFile, offset, loaded, min, max, batchMin, batchMax)) {
+    printf("Failed to validate %s\n", outFile);
+    return false;
+  }
+
+  printf("Cooked %s -> %s\n", inFile, outFile);
+  return true;
+}
+
+static bool cook_level(const char* levelFileName) {
+  LevelData level;
+  MappedFile levelFile;
+  if (!load_level_from_file(levelFileName, levelFile, level)) {
+    printf("Failed to load level %s\n", levelFileName);
+    return false;
+  }
+
+  bool success = true;
+  for (uint32_t i = 0; i < level.header->sectorCount; i++) {
+    const LevelSector& sector = level.sectors[i];
+    const char* modelName = level.getString(sector.modelName);
+    success &= cook_file(modelName, get_cooked_model_name(modelName).c_str(), glm::make_vec3(sector.offset));
+  }
+  return success;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc == 2) {
+    return cook_level(argv[1]) ? 0 : 1;
+  }
+  if (argc == 3 || argc == 6) {
+    vec3 offset(0.0f);
+    if (argc == 6) {
+      offset = vec3((float)atof(argv[3]), (float)atof(argv[4]), (float)atof(argv[5]));
+    }
+    return cook_file(argv[1], argv[2], offset) ? 0 : 1;
+  }
+
+  printf("Usage:\n");
+  printf("  ModelCooker <level file>\n");
+  printf("  ModelCooker <model file> <out file> [x y z]\n");
+  return 1;
+}
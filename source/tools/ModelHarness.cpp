@@ -0,0 +1,153 @@
+// Model loader fuzzing and benchmark harness
+// Feeds truncated and randomly mutated copies of model files to load_model_from_memory (which must reject bad data without
+// reading out of bounds, best run with a sanitizer build), then times the copying and the memory mapped loaders.
+//
+// Usage:
+//   ModelHarness [iterations] [model files...]   - defaults to 1000 iterations over data/room0-4.hmdl
+#include "../framework/Model.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+// Deterministic so failures can be reproduced
+struct HarnessRandom {
+  uint32_t state = 0x12345678;
+
+  inline uint32_t next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+};
+
+static bool read_file(const char* fileName, std::vector<uint8_t>& ret_data) {
+  FILE* file = fopen(fileName, "rb");
+  if (file == NULL) return false;
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  bool success = false;
+  if (size > 0) {
+    ret_data.resize(size);
+    success = (fread(ret_data.data(), size, 1, file) == 1);
+  }
+  fclose(file);
+  return success;
+}
+
+// Check a loaded model only references the passed data and its indices are in range
+static bool check_model(const Model& model, const uint8_t* data, size_t size) {
+  for (const Batch& batch : model.batches) {
+    uint64_t vertexBytes = uint64_t(batch.nVertices) * batch.vertexSize;
+    uint64_t indexBytes = uint64_t(batch.nIndices) * batch.indexSize;
+    if (batch.vertexData < data || batch.vertexData + vertexBytes > data + size ||
+        batch.indexData < data || batch.indexData + indexBytes > data + size) {
+      return false;
+    }
+    for (uint32_t i = 0; i < batch.nIndices; i++) {
+      uint32_t index = 0;
+      memcpy(&index, batch.indexData + size_t(i) * batch.indexSize, batch.indexSize);
+      if (index >= batch.nVertices) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Load a copy of the data (the loader may modify it in place), returns false if the model was accepted but is invalid
+static bool fuzz_load(const std::vector<uint8_t>& data, size_t size, uint32_t& ret_accepted) {
+  std::vector<uint8_t> copy(data.begin(), data.begin() + size);
+  Model model;
+  if (!load_model_from_memory(copy.data(), copy.size(), model)) {
+    return true;
+  }
+  ret_accepted++;
+  return check_model(model, copy.data(), copy.size());
+}
+
+static bool fuzz_file(const char* fileName, uint32_t iterations) {
+  std::vector<uint8_t> data;
+  if (!read_file(fileName, data)) {
+    printf("Failed to read %s\n", fileName);
+    return false;
+  }
+
+  uint32_t failures = 0;
+  uint32_t accepted = 0;
+  uint32_t loads = 0;
+
+  // Every truncated length of the file
+  for (size_t size = 0; size < data.size(); size++) {
+    failures += fuzz_load(data, size, accepted) ? 0 : 1;
+    loads++;
+  }
+
+  // Random byte changes, mostly in the headers where they change sizes and counts
+  HarnessRandom random;
+  std::vector<uint8_t> mutated;
+  for (uint32_t i = 0; i < iterations; i++) {
+    mutated = data;
+    uint32_t changes = 1 + random.next() % 8;
+    for (uint32_t c = 0; c < changes; c++) {
+      size_t range = (random.next() & 1) ? data.size() : std::min<size_t>(data.size(), 256);
+      mutated[random.next() % range] = (uint8_t)random.next();
+    }
+    failures += fuzz_load(mutated, mutated.size(), accepted) ? 0 : 1;
+    loads++;
+  }
+
+  printf("Fuzzed %s: %u loads, %u accepted, %u invalid\n", fileName, loads, accepted, failures);
+  return failures == 0;
+}
+
+static void benchmark_file(const char* fileName, uint32_t iterations) {
+  typedef std::chrono::high_resolution_clock Clock;
+
+  Clock::time_point start = Clock::now();
+  for (uint32_t i = 0; i < iterations; i++) {
+    Model model;
+    load_model_from_file(fileName, model);
+  }
+  double copyMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+
+  start = Clock::now();
+  for (uint32_t i = 0; i < iterations; i++) {
+    Model model;
+    load_model_from_mapped_file(fileName, model);
+  }
+  double mappedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+
+  printf("Loaded %s: %.4f ms copied, %.4f ms mapped\n", fileName, copyMs, mappedMs);
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t iterations = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1000;
+  if (iterations == 0) {
+    printf("Usage:\n");
+    printf("  ModelHarness [iterations] [model files...]\n");
+    return 1;
+  }
+
+  std::vector<const char*> files;
+  for (int i = 2; i < argc; i++) {
+    files.push_back(argv[i]);
+  }
+  if (files.empty()) {
+    files = { "data/room0.hmdl", "data/room1.hmdl", "data/room2.hmdl", "data/room3.hmdl", "data/room4.hmdl" };
+  }
+
+  bool success = true;
+  for (const char* file : files) {
+    success &= fuzz_file(file, iterations);
+  }
+  for (const char* file : files) {
+    benchmark_file(file, iterations);
+  }
+  return success ? 0 : 1;
+}
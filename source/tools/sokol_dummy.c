@@ -0,0 +1,2 @@
+#define SOKOL_IMPL
+#include "../framework/external/sokol_gfx.h"